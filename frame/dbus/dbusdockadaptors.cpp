@@ -21,6 +21,13 @@
 
 #include "dbusdockadaptors.h"
 #include "../util/utils.h"
+#include "../util/thumbnailcache.h"
+#include "../window/dockitemmanager.h"
+#include "../item/components/appeffect.h"
+#include "../util/animationclock.h"
+#include "../util/perfstatistics.h"
+#include "../util/docksettings.h"
+#include "../taskmanager/taskmanager.h"
 #include "../window/mainwindow.h"
 #include "TopPanelInterface.h"
 
@@ -140,6 +147,46 @@ void DBusDockAdaptors::setItemOnDock(const QString settingKey, const QString &it
     m_topPanelInterface->setItemOnDock(settingKey, itemKey, visible);
 }
 
+QVariantMap DBusDockAdaptors::thumbnailCacheStatistics()
+{
+    return ThumbnailCache::instance()->statistics();
+}
+
+QVariantMap DBusDockAdaptors::thumbnailRefreshStatistics()
+{
+    return DockItemManager::instance()->thumbnailScheduler()->statistics();
+}
+
+QVariantMap DBusDockAdaptors::effectStatistics()
+{
+    return AppEffect::statistics();
+}
+
+QVariantMap DBusDockAdaptors::animationStatistics()
+{
+    return AnimationClock::instance()->statistics();
+}
+
+QVariantMap DBusDockAdaptors::perfStatistics()
+{
+    return PerfStatistics::instance()->statistics();
+}
+
+void DBusDockAdaptors::resetPerfStatistics()
+{
+    PerfStatistics::instance()->reset();
+}
+
+QVariantMap DBusDockAdaptors::settingsCacheStatistics()
+{
+    return DockSettings::instance()->statistics();
+}
+
+QVariantMap DBusDockAdaptors::appListPersistStatistics()
+{
+    return TaskManager::instance()->persistStatistics();
+}
+
 QRect DBusDockAdaptors::geometry() const
 {
     return m_window->geometry();
@@ -93,6 +93,35 @@ class DBusDockAdaptors: public QDBusAbstractAdaptor
                                        "        <arg name=\"itemKey\" type=\"s\" direction=\"in\"/>"
                                        "        <arg name=\"visible\" type=\"b\" direction=\"in\"/>"
                                        "    </method>"
+                                       "    <method name=\"thumbnailCacheStatistics\">"
+                                       "        <arg name=\"statistics\" type=\"a{sv}\" direction=\"out\"/>"
+                                       "        <annotation value=\"QVariantMap\" name=\"org.qtproject.QtDBus.QtTypeName.Out0\"/>\n"
+                                       "    </method>"
+                                       "    <method name=\"thumbnailRefreshStatistics\">"
+                                       "        <arg name=\"statistics\" type=\"a{sv}\" direction=\"out\"/>"
+                                       "        <annotation value=\"QVariantMap\" name=\"org.qtproject.QtDBus.QtTypeName.Out0\"/>\n"
+                                       "    </method>"
+                                       "    <method name=\"effectStatistics\">"
+                                       "        <arg name=\"statistics\" type=\"a{sv}\" direction=\"out\"/>"
+                                       "        <annotation value=\"QVariantMap\" name=\"org.qtproject.QtDBus.QtTypeName.Out0\"/>\n"
+                                       "    </method>"
+                                       "    <method name=\"animationStatistics\">"
+                                       "        <arg name=\"statistics\" type=\"a{sv}\" direction=\"out\"/>"
+                                       "        <annotation value=\"QVariantMap\" name=\"org.qtproject.QtDBus.QtTypeName.Out0\"/>\n"
+                                       "    </method>"
+                                       "    <method name=\"perfStatistics\">"
+                                       "        <arg name=\"statistics\" type=\"a{sv}\" direction=\"out\"/>"
+                                       "        <annotation value=\"QVariantMap\" name=\"org.qtproject.QtDBus.QtTypeName.Out0\"/>\n"
+                                       "    </method>"
+                                       "    <method name=\"resetPerfStatistics\"/>"
+                                       "    <method name=\"settingsCacheStatistics\">"
+                                       "        <arg name=\"statistics\" type=\"a{sv}\" direction=\"out\"/>"
+                                       "        <annotation value=\"QVariantMap\" name=\"org.qtproject.QtDBus.QtTypeName.Out0\"/>\n"
+                                       "    </method>"
+                                       "    <method name=\"appListPersistStatistics\">"
+                                       "        <arg name=\"statistics\" type=\"a{sv}\" direction=\"out\"/>"
+                                       "        <annotation value=\"QVariantMap\" name=\"org.qtproject.QtDBus.QtTypeName.Out0\"/>\n"
+                                       "    </method>"
                                        "    <signal name=\"pluginVisibleChanged\">"
                                        "        <arg type=\"s\"/>"
                                        "        <arg type=\"b\"/>"
@@ -121,6 +150,15 @@ public Q_SLOTS: // METHODS
     void setPluginVisible(const QString &pluginName, bool visible);
     void setItemOnDock(const QString settingKey, const QString &itemKey, bool visible);
 
+    QVariantMap thumbnailCacheStatistics();
+    QVariantMap thumbnailRefreshStatistics();
+    QVariantMap effectStatistics();
+    QVariantMap animationStatistics();
+    QVariantMap perfStatistics();
+    void resetPerfStatistics();
+    QVariantMap settingsCacheStatistics();
+    QVariantMap appListPersistStatistics();
+
 public: // PROPERTIES
     QRect geometry() const;
 
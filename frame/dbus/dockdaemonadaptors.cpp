@@ -6,17 +6,41 @@
 #include "../util/docksettings.h"
 #include "../taskmanager/taskmanager.h"
 
+#include <QTimer>
+
+#define DOCK_DAEMON_PATH "/org/deepin/dde/daemon/Dock1"
+#define DOCK_DAEMON_INTERFACE "org.deepin.dde.daemon.Dock1"
+
 DockDaemonDBusAdaptor::DockDaemonDBusAdaptor(QObject *parent)
     : QDBusAbstractAdaptor(parent)
+    , m_flushScheduled(false)
+    , m_emittedCount(0)
+    , m_coalescedCount(0)
 {
     // constructor
     setAutoRelaySignals(true);
-    connect(TaskManager::instance(), &TaskManager::entryAdded, this, &DockDaemonDBusAdaptor::EntryAdded);
-    connect(TaskManager::instance(), &TaskManager::entryRemoved, this, &DockDaemonDBusAdaptor::EntryRemoved);
-    connect(TaskManager::instance(), &TaskManager::hideStateChanged, this, &DockDaemonDBusAdaptor::HideStateChanged);
-    connect(TaskManager::instance(), &TaskManager::frontendWindowRectChanged, this, &DockDaemonDBusAdaptor::FrontendWindowRectChanged);
-    connect(TaskManager::instance(), &TaskManager::showRecentChanged, this, &DockDaemonDBusAdaptor::showRecentChanged);
-    connect(TaskManager::instance(), &TaskManager::showMultiWindowChanged, this, &DockDaemonDBusAdaptor::ShowMultiWindowChanged);
+    connect(TaskManager::instance(), &TaskManager::entryAdded, this, [this](const Entry *entry, int index) {
+        ++m_emittedCount;
+        Q_EMIT EntryAdded(entry, index);
+    });
+    connect(TaskManager::instance(), &TaskManager::entryRemoved, this, [this](const QString &entryId) {
+        ++m_emittedCount;
+        Q_EMIT EntryRemoved(entryId);
+    });
+
+    // 属性变化不再逐个发信号，合并到一条 PropertiesChanged 中
+    connect(TaskManager::instance(), &TaskManager::hideStateChanged, this, [this](int value) {
+        notifyPropertyChanged("HideState", value);
+    });
+    connect(TaskManager::instance(), &TaskManager::frontendWindowRectChanged, this, [this](const QRect &dockRect) {
+        notifyPropertyChanged("FrontendWindowRect", dockRect);
+    });
+    connect(TaskManager::instance(), &TaskManager::showRecentChanged, this, [this](bool value) {
+        notifyPropertyChanged("ShowRecent", value);
+    });
+    connect(TaskManager::instance(), &TaskManager::showMultiWindowChanged, this, [this](bool value) {
+        notifyPropertyChanged("ShowMultiWindow", value);
+    });
 }
 
 DockDaemonDBusAdaptor::~DockDaemonDBusAdaptor()
@@ -24,6 +48,72 @@ DockDaemonDBusAdaptor::~DockDaemonDBusAdaptor()
     // destructor
 }
 
+/**
+ * @brief DockDaemonDBusAdaptor::notifyPropertyChanged 记录属性的最新值，本轮事件循环结束后统一发送
+ */
+void DockDaemonDBusAdaptor::notifyPropertyChanged(const QString &name, const QVariant &value)
+{
+    if (m_flushScheduled)
+        ++m_coalescedCount;
+
+    m_pendingProperties.insert(name, value);
+
+    if (!m_flushScheduled) {
+        m_flushScheduled = true;
+        QTimer::singleShot(0, this, &DockDaemonDBusAdaptor::flushPropertyChanges);
+    }
+}
+
+void DockDaemonDBusAdaptor::flushPropertyChanges()
+{
+    m_flushScheduled = false;
+    if (m_pendingProperties.isEmpty())
+        return;
+
+    QVariantMap properties;
+    properties.swap(m_pendingProperties);
+
+    QDBusMessage message = QDBusMessage::createSignal(DOCK_DAEMON_PATH, "org.freedesktop.DBus.Properties", "PropertiesChanged");
+    message << QString(DOCK_DAEMON_INTERFACE) << properties << QStringList();
+
+    if (QDBusConnection::sessionBus().send(message))
+        ++m_emittedCount;
+
+    // 兼容仍在监听旧的 xxxChanged 信号的客户端，每个属性每轮只发一次最新值
+    for (auto it = properties.constBegin(); it != properties.constEnd(); ++it)
+        emitLegacySignal(it.key(), it.value());
+}
+
+void DockDaemonDBusAdaptor::emitLegacySignal(const QString &name, const QVariant &value)
+{
+    if (name == "HideMode")
+        Q_EMIT HideModeChanged(value.toInt());
+    else if (name == "HideState")
+        Q_EMIT HideStateChanged(value.toInt());
+    else if (name == "HideTimeout")
+        Q_EMIT HideTimeoutChanged(value.toUInt());
+    else if (name == "WindowSizeEfficient")
+        Q_EMIT WindowSizeEfficientChanged(value.toUInt());
+    else if (name == "WindowSizeFashion")
+        Q_EMIT WindowSizeFashionChanged(value.toUInt());
+    else if (name == "FrontendWindowRect")
+        Q_EMIT FrontendWindowRectChanged(value.toRect());
+    else if (name == "IconSize")
+        Q_EMIT IconSizeChanged(value.toUInt());
+    else if (name == "Position")
+        Q_EMIT PositionChanged(value.toInt());
+    else if (name == "ShowTimeout")
+        Q_EMIT ShowTimeoutChanged(value.toUInt());
+    else if (name == "ShowRecent")
+        Q_EMIT showRecentChanged(value.toBool());
+    else if (name == "ShowMultiWindow")
+        Q_EMIT ShowMultiWindowChanged(value.toBool());
+    else
+        return;
+
+    ++m_emittedCount;
+}
+
 int DockDaemonDBusAdaptor::displayMode() const
 {
     return 0;
@@ -47,7 +137,7 @@ void DockDaemonDBusAdaptor::setHideMode(int value)
 {
     if (hideMode() != value) {
         TaskManager::instance()->setHideMode(static_cast<HideMode>(value));
-        Q_EMIT HideModeChanged(value);
+        notifyPropertyChanged("HideMode", value);
     }
 }
 
@@ -65,7 +155,7 @@ void DockDaemonDBusAdaptor::setHideTimeout(uint value)
 {
     if (hideTimeout() != value) {
         TaskManager::instance()->setHideTimeout(value);
-        Q_EMIT HideTimeoutChanged(value);
+        notifyPropertyChanged("HideTimeout", value);
     }
 }
 
@@ -78,7 +168,7 @@ void DockDaemonDBusAdaptor::setWindowSizeEfficient(uint value)
 {
     if (windowSizeEfficient() != value) {
         TaskManager::instance()->setWindowSizeFashion(value);
-        Q_EMIT WindowSizeEfficientChanged(value);
+        notifyPropertyChanged("WindowSizeEfficient", value);
     }
 }
 
@@ -91,7 +181,7 @@ void DockDaemonDBusAdaptor::setWindowSizeFashion(uint value)
 {
     if (windowSizeFashion() != value) {
         TaskManager::instance()->setWindowSizeFashion(value);
-        Q_EMIT WindowSizeFashionChanged(value);
+        notifyPropertyChanged("WindowSizeFashion", value);
     }
 }
 
@@ -109,7 +199,7 @@ void DockDaemonDBusAdaptor::setIconSize(uint value)
 {
     if (iconSize() != value) {
         TaskManager::instance()->setIconSize(value);
-        Q_EMIT IconSizeChanged(value);
+        notifyPropertyChanged("IconSize", value);
     }
 }
 
@@ -122,7 +212,7 @@ void DockDaemonDBusAdaptor::setPosition(int value)
 {
     if (position() != value) {
         TaskManager::instance()->setPosition(value);
-        Q_EMIT PositionChanged(value);
+        notifyPropertyChanged("Position", value);
     }
 }
 
@@ -135,7 +225,7 @@ void DockDaemonDBusAdaptor::setShowTimeout(uint value)
 {
     if (showTimeout() != value) {
         TaskManager::instance()->setShowTimeout(value);
-        Q_EMIT ShowTimeoutChanged(value);
+        notifyPropertyChanged("ShowTimeout", value);
     }
 }
 
@@ -229,3 +319,11 @@ void DockDaemonDBusAdaptor::SetFrontendWindowRect(int x, int y, uint width, uint
 {
     TaskManager::instance()->setFrontendWindowRect(x, y, width, height);
 }
+
+QVariantMap DockDaemonDBusAdaptor::NotificationStatistics()
+{
+    QVariantMap statistics;
+    statistics.insert("emitted", m_emittedCount);
+    statistics.insert("coalesced", m_coalescedCount);
+    return statistics;
+}
@@ -88,6 +88,10 @@ class DockDaemonDBusAdaptor: public QDBusAbstractAdaptor
                                        "      <arg direction=\"in\" type=\"u\" name=\"width\"/>\n"
                                        "      <arg direction=\"in\" type=\"u\" name=\"height\"/>\n"
                                        "    </method>\n"
+                                       "    <method name=\"NotificationStatistics\">\n"
+                                       "      <arg direction=\"out\" type=\"a{sv}\" name=\"statistics\"/>\n"
+                                       "      <annotation value=\"QVariantMap\" name=\"org.qtproject.QtDBus.QtTypeName.Out0\"/>\n"
+                                       "    </method>\n"
                                        "    <signal name=\"ServiceRestarted\"/>\n"
                                        "    <signal name=\"EntryAdded\">\n"
                                        "      <arg type=\"o\" name=\"path\"/>\n"
@@ -180,6 +184,7 @@ public Q_SLOTS: // METHODS
     void SetShowRecent(bool visible);
     void SetShowMultiWindow(bool showMultiWindow);
     void SetFrontendWindowRect(int x, int y, uint width, uint height);
+    QVariantMap NotificationStatistics();
 
 Q_SIGNALS: // SIGNALS
     void ServiceRestarted();
@@ -200,4 +205,15 @@ Q_SIGNALS: // SIGNALS
     void WindowSizeFashionChanged(uint value) const;
     void showRecentChanged(bool) const;
     void ShowMultiWindowChanged(bool) const;
+
+private:
+    void notifyPropertyChanged(const QString &name, const QVariant &value);
+    void flushPropertyChanges();
+    void emitLegacySignal(const QString &name, const QVariant &value);
+
+private:
+    QVariantMap m_pendingProperties;    // 本轮事件循环内变化的属性，只保留最新值
+    bool m_flushScheduled;
+    quint64 m_emittedCount;             // 实际发到总线上的信号数
+    quint64 m_coalescedCount;           // 合并进同一条 PropertiesChanged 而省掉的通知数
 };
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "components/appsnapshot.h"
 #include "components/previewcontainer.h"
 #include "util/XUtils.h"
+#include "util/thumbnailcache.h"
+#include "window/dockitemmanager.h"
 #include "xcb/xcb_misc.h"
 
 #include <dtkwidget_global.h>
@@ -12,86 +14,10 @@
 #include <X11/X.h>
 #include <X11/Xutil.h>
 #include <X11/Xatom.h>
-#include <sys/shm.h>
 #include <KWindowSystem>
 #include <QMouseEvent>
 #include <QDragEnterEvent>
 
-SHMInfo *getImageDSHM(WId wId)
-{
-    const auto display = QX11Info::display();
-
-    Atom atom_prop = XInternAtom(display, "_DEEPIN_DXCB_SHM_INFO", true);
-    if (!atom_prop) {
-        return nullptr;
-    }
-
-    Atom actual_type_return_deepin_shm;
-    int actual_format_return_deepin_shm;
-    unsigned long nitems_return_deepin_shm;
-    unsigned long bytes_after_return_deepin_shm;
-    unsigned char *prop_return_deepin_shm;
-
-    XGetWindowProperty(display, wId, atom_prop, 0, 32 * 9, false, AnyPropertyType,
-                    &actual_type_return_deepin_shm, &actual_format_return_deepin_shm, &nitems_return_deepin_shm,
-                    &bytes_after_return_deepin_shm, &prop_return_deepin_shm);
-
-    return reinterpret_cast<SHMInfo *>(prop_return_deepin_shm);
-}
-
-XImage *getImageXlib(WId wId)
-{
-    const auto display = QX11Info::display();
-    Window unused_window;
-    int unused_int;
-    unsigned unused_uint, w, h;
-    XGetGeometry(display, wId, &unused_window, &unused_int, &unused_int, &w, &h, &unused_uint, &unused_uint);
-    return XGetImage(display, wId, 0, 0, w, h, AllPlanes, ZPixmap);
-}
-
-QRect rectRemovedShadow(WId wId, const QImage &qimage, unsigned char *prop_to_return_gtk)
-{
-    const auto display = QX11Info::display();
-
-    const Atom gtk_frame_extents = XInternAtom(display, "_GTK_FRAME_EXTENTS", true);
-    Atom actual_type_return_gtk;
-    int actual_format_return_gtk;
-    unsigned long n_items_return_gtk;
-    unsigned long bytes_after_return_gtk;
-
-    const auto r = XGetWindowProperty(display, wId, gtk_frame_extents, 0, 4, false, XA_CARDINAL,
-                                    &actual_type_return_gtk, &actual_format_return_gtk, &n_items_return_gtk, &bytes_after_return_gtk, &prop_to_return_gtk);
-    if (!r && prop_to_return_gtk && n_items_return_gtk == 4 && actual_format_return_gtk == 32) {
-        qDebug() << "remove shadow frame...";
-        const unsigned long *extents = reinterpret_cast<const unsigned long *>(prop_to_return_gtk);
-        const int left = extents[0];
-        const int right = extents[1];
-        const int top = extents[2];
-        const int bottom = extents[3];
-        const int width = qimage.width();
-        const int height = qimage.height();
-
-        return QRect(left, top, width - left - right, height - top - bottom);
-    } else {
-        return QRect(0, 0, qimage.width(), qimage.height());
-    }
-}
-
-struct SHMInfo {
-    long shmid;
-    long width;
-    long height;
-    long bytesPerLine;
-    long format;
-
-    struct Rect {
-        long x;
-        long y;
-        long width;
-        long height;
-    } rect;
-};
-
 WindowItem::WindowItem(AppItem *appItem, WId wId, WindowInfo windowInfo, bool closeable, QWidget *parent) :
     DockItem(parent)
     , m_appItem(appItem)
@@ -101,11 +27,13 @@ WindowItem::WindowItem(AppItem *appItem, WId wId, WindowInfo windowInfo, bool cl
 {
     m_icon = m_appItem->appIcon();
 
-    timer = new QTimer(this);
-    timer->setSingleShot(false);
-    timer->setInterval(10000);
-    connect(timer, &QTimer::timeout, this, &WindowItem::fetchSnapshot);
-    timer->start();
+    // 定时刷新由 DockItemManager 的 ThumbnailScheduler 统一调度
+    DockItemManager::instance()->thumbnailScheduler()->addItem(this);
+
+    connect(ThumbnailCache::instance(), &ThumbnailCache::thumbnailChanged, this, &WindowItem::onSnapshotReady);
+    connect(ThumbnailCache::instance(), &ThumbnailCache::thumbnailFailed, this, [this](const WId wid){
+        if(wid == m_WId) m_appItem->check();
+    });
 
     m_updateIconGeometryTimer = new QTimer(this);
     m_updateIconGeometryTimer->setInterval(500);
@@ -117,20 +45,24 @@ WindowItem::WindowItem(AppItem *appItem, WId wId, WindowInfo windowInfo, bool cl
     });
 
     update();
-
-    QTimer::singleShot(2000, this, &WindowItem::fetchSnapshot);
 }
 
 WindowItem::~WindowItem() {}
 
-void WindowItem::paintEvent(QPaintEvent *e)
+bool WindowItem::isMinimized() const
+{
+    Entry *entry = TaskManager::instance()->getEntryByWindowId(m_WId);
+    WindowInfoBase *info = entry ? entry->getWindowInfoByWinId(m_WId) : nullptr;
+    return info && info->isMinimized();
+}
+
+void WindowItem::paintItem(QPainter &painter)
 {
     if(isScaling()) return;
 
     if(m_snapshot.isNull())
-        return DockItem::paintEvent(e);
+        return DockItem::paintItem(painter);
 
-    QPainter painter(this);
     painter.save();
 
     const QRectF itemRect = rect();
@@ -187,9 +119,7 @@ void WindowItem::resizeEvent(QResizeEvent *e)
 void WindowItem::enterEvent(QEvent *e)
 {
     DockItem::enterEvent(e);
-    timer->stop();
     fetchSnapshot();
-    timer->start();
 }
 
 void WindowItem::leaveEvent(QEvent *e)
@@ -279,67 +209,20 @@ void WindowItem::fetchSnapshot()
 {
     if(this->window()->isVisible() == false) return;
 
-    QImage qimage;
-    SHMInfo *info = nullptr;
-    uchar *image_data = nullptr;
-    XImage *ximage = nullptr;
-    unsigned char *prop_to_return_gtk = nullptr;
-
-    do {
-        // get window image from shm(only for deepin app)
-        info = getImageDSHM(m_WId);
-        if (info) {
-            // qInfo() << "get Image from dxcbplugin SHM...";
-            //qDebug() << info->shmid << info->width << info->height << info->bytesPerLine << info->format << info->rect.x << info->rect.y << info->rect.width << info->rect.height;
-            image_data = (uchar *)shmat(info->shmid, 0, 0);
-            if ((qint64)image_data != -1) {
-                m_snapshot = QImage(image_data, info->width, info->height, info->bytesPerLine, (QImage::Format)info->format);
-                m_snapshotSrcRect = QRect(info->rect.x, info->rect.y, info->rect.width, info->rect.height);
-                break;
-            }
-            // qInfo() << "invalid pointer of shm!";
-            image_data = nullptr;
-        }
-
-        if (!image_data || qimage.isNull()) {
-            // get window image from XGetImage(a little slow)
-            // qInfo() << "get Image from dxcbplugin SHM failed!";
-            // qInfo() << "get Image from Xlib...";
-            ximage = getImageXlib(m_WId);
-            if (!ximage) {
-                // qInfo() << "get Image from Xlib failed! giving up...";
-                m_appItem->check();
-                return;
-            }
-            qimage = QImage((const uchar *)(ximage->data), ximage->width, ximage->height, ximage->bytes_per_line, QImage::Format_RGB32);
-        }
-
-        Q_ASSERT(!qimage.isNull());
-
-        // remove shadow frame
-        m_snapshotSrcRect = rectRemovedShadow(m_WId, qimage, prop_to_return_gtk);
-        m_snapshot = qimage;
-    } while (false);
-
-
-    QSizeF size(rect().marginsRemoved(QMargins(rect().width() * .1,  rect().height() * .1, rect().width() * .1, rect().height() * .1)).size());
     const auto ratio = devicePixelRatioF();
-    size = m_snapshotSrcRect.size().scaled(size * ratio, Qt::KeepAspectRatio);
+    m_snapshotSize = rect().marginsRemoved(QMargins(rect().width() * .1,  rect().height() * .1, rect().width() * .1, rect().height() * .1)).size() * ratio;
 
-    qreal scale = qreal(size.width()) / m_snapshotSrcRect.width();
-    m_snapshot = m_snapshot.scaled(qRound(m_snapshot.width() * scale), qRound(m_snapshot.height() * scale), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-
-    m_snapshotSrcRect.moveTop(m_snapshotSrcRect.top() * scale + 0.5);
-    m_snapshotSrcRect.moveLeft(m_snapshotSrcRect.left() * scale + 0.5);
-    m_snapshotSrcRect.setWidth(size.width() - 0.5);
-    m_snapshotSrcRect.setHeight(size.height() - 0.5);
+    const QImage image = ThumbnailCache::instance()->thumbnail(m_WId, m_snapshotSize, ratio, underMouse() ? SnapshotCapturer::Visible : SnapshotCapturer::Background);
+    if(!image.isNull())
+        onSnapshotReady(m_WId, m_snapshotSize, image);
+}
 
-    m_snapshot.setDevicePixelRatio(ratio);
+void WindowItem::onSnapshotReady(const WId wid, const QSize &size, const QImage &image)
+{
+    if(wid != m_WId || size != m_snapshotSize || image.cacheKey() == m_snapshot.cacheKey()) return;
 
-    if (image_data) shmdt(image_data);
-    if (ximage) XDestroyImage(ximage);
-    if (info) XFree(info);
-    if (prop_to_return_gtk) XFree(prop_to_return_gtk);
+    m_snapshot = image;
+    m_snapshotSrcRect = QRectF(0, 0, image.width() - 0.5, image.height() - 0.5);
 
     update();
 }
@@ -14,10 +14,12 @@ class WindowItem : public DockItem
         explicit WindowItem(AppItem *appItem, WId wId, WindowInfo windowInfoBase, bool closeable, QWidget *parent=Q_NULLPTR);
         ~WindowItem();
         ItemType itemType() const override { return DockItem::Window; }
+        WId wid() const { return m_WId; }
+        bool isMinimized() const;
         void fetchSnapshot();
 
     protected:
-        void paintEvent(QPaintEvent *e) override;
+        void paintItem(QPainter &painter) override;
         void mouseReleaseEvent(QMouseEvent *e) override;
         void wheelEvent(QWheelEvent *e) override;
         void moveEvent(QMoveEvent *e) override;
@@ -35,6 +37,7 @@ class WindowItem : public DockItem
         void showPreview();
         void showHoverTips() override;
         void closeWindow();
+        void onSnapshotReady(const WId wid, const QSize &size, const QImage &image);
 
     private:
         AppItem *m_appItem;
@@ -43,7 +46,7 @@ class WindowItem : public DockItem
         bool m_closeable;
         QImage m_snapshot;
         QRectF m_snapshotSrcRect;
-        QTimer *timer;
+        QSize m_snapshotSize;
         QTimer *m_updateIconGeometryTimer;
 };
 
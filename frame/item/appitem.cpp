@@ -108,11 +108,10 @@ void AppItem::moveEvent(QMoveEvent *e)
         m_updateIconGeometryTimer->start();
 }
 
-void AppItem::paintEvent(QPaintEvent *e)
+void AppItem::paintItem(QPainter &painter)
 {
     if (m_itemAnimation != nullptr || isScaling()) return;
 
-    QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing, true);
     painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
 
@@ -402,6 +401,9 @@ void AppItem::refreshIcon()
     const QString icon = m_itemEntry->getIcon();
     m_icon.addPixmap(Utils::getIcon(icon, 100 * 0.85, devicePixelRatioF()));
     update();
+
+    if(m_dirItem)
+        m_dirItem->invalidateComposite();
 }
 
 void AppItem::requestActivateWindow(const WId wid) {
@@ -435,7 +437,7 @@ void AppItem::playSwingEffect()
     connect(m_itemAnimation, &QVariantAnimation::stateChanged, this, [this](const QVariantAnimation::State &newState, const QVariantAnimation::State &oldState) {
         if (newState == QVariantAnimation::Stopped) {
             m_itemAnimation = nullptr;
-            update();
+            updateOnFrame();
 
             if (m_place == DirPlace)
                 m_dirItem->hideDirpopupWindow();
@@ -447,7 +449,7 @@ void AppItem::playSwingEffect()
     });
 
     m_itemAnimation->start();
-    update();
+    updateOnFrame();
 }
 
 void AppItem::handleDragDrop(uint timestamp, const QStringList &uris)
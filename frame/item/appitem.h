@@ -77,7 +77,7 @@ signals:
 
 private:
     void moveEvent(QMoveEvent *e) override;
-    void paintEvent(QPaintEvent *e) override;
+    void paintItem(QPainter &painter) override;
     void mouseReleaseEvent(QMouseEvent *e) override;
     void wheelEvent(QWheelEvent *e) override;
     void resizeEvent(QResizeEvent *e) override;
@@ -2,12 +2,13 @@
 
 #include <QDrag>
 #include <QMouseEvent>
+#include <QApplication>
+
+#define COLUMN_COUNT 4
 
 static bool autoHide = true;
 
 AppDirWidget::AppDirWidget(QString title, QWidget *parent) : QWidget(parent)
-, m_row(0)
-, m_column(0)
 , m_mouseLeaveTimer(new QTimer(this))
 {
     QVBoxLayout *vbox = new QVBoxLayout(this);
@@ -44,66 +45,69 @@ AppDirWidget::AppDirWidget(QString title, QWidget *parent) : QWidget(parent)
     // setFixedWidth(360);
     setMinimumHeight(120);
     setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Expanding);
+    setAcceptDrops(true);
     hide();
 }
 
+void AppDirWidget::placeItem(int index)
+{
+    // 同一父控件内移动格子不会重新设置父对象
+    m_Layout->addWidget(m_items.at(index), index / COLUMN_COUNT, index % COLUMN_COUNT);
+}
+
 void AppDirWidget::addAppItem(AppItem *item)
 {
-    m_Layout->addWidget(item, m_row, m_column++);
-    item->installEventFilter(this);
+    if(m_items.contains(item))
+        return;
 
-    if(m_column == 4)
-    {
-        m_row++;
-        m_column = 0;
-    }
+    m_items.append(item);
+    placeItem(m_items.size() - 1);
+    item->installEventFilter(this);
 
     connect(item, &DockItem::requestWindowAutoHide, this, [ this ](bool hide) {
         autoHide = hide;
         if(!hide)
             m_mouseLeaveTimer->stop();
     });
-    m_Layout->update();
 }
 
 void AppDirWidget::removeAppItem(AppItem *item)
 {
-    bool bingo = false;
-    int row=0, column=0;
-    while (row < m_row && column < 4)
+    const int index = m_items.indexOf(item);
+    if(index != -1)
     {
-        if(bingo)
-        {
-            if(row < m_row || (row == m_row && column <= m_column))
-            {
-                m_Layout->addItem(m_Layout->itemAtPosition(row, column), column == 0 ? row - 1 : row, column == 0 ? 3 : column - 1);
-            }
-        }
-        else if(m_Layout->itemAtPosition(row, column)->widget() == item)
-        {
-            m_Layout->removeWidget(item);
-            bingo = true;
-        }
+        m_Layout->removeWidget(item);
+        m_items.removeAt(index);
 
-        column ++;
-        if(column == 4)
+        // 后面的项各前移一格
+        for(int i = index; i < m_items.size(); ++i)
         {
-            row++;
-            column = 0;
+            m_Layout->removeWidget(m_items.at(i));
+            placeItem(i);
         }
     }
 
-    if(bingo)
-    {
-        m_column = m_column == 0 ? 3 : m_column -1;
-        if(m_column == 3)
-            m_row--;
-    }
-
     item->removeEventFilter(this);
 
     disconnect(item, &DockItem::requestWindowAutoHide, this, 0);
-    m_Layout->update();
+}
+
+/**
+ * @brief AppDirWidget::moveAppItem 把第 from 项移到第 to 项，只有两者之间的项换了格子
+ */
+void AppDirWidget::moveAppItem(int from, int to)
+{
+    if(from == to || from < 0 || to < 0 || from >= m_items.size() || to >= m_items.size())
+        return;
+
+    m_items.move(from, to);
+
+    const int first = qMin(from, to);
+    const int last = qMax(from, to);
+    for(int i = first; i <= last; ++i)
+        m_Layout->removeWidget(m_items.at(i));
+    for(int i = first; i <= last; ++i)
+        placeItem(i);
 }
 
 void AppDirWidget::prepareHide()
@@ -139,13 +143,19 @@ bool AppDirWidget::eventFilter(QObject* object, QEvent* event)
         // return true;
     }
 
-    if(event->type() == QEvent::MouseMove)
+    if(event->type() == QEvent::MouseButtonPress)
+    {
+        m_dragStartPos = static_cast<QMouseEvent *>(event)->globalPos();
+    }
+    else if(event->type() == QEvent::MouseMove)
     {
         QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
-        if (mouseEvent && mouseEvent->buttons() == Qt::LeftButton)
+        // 超过拖拽距离才开始拖拽，避免按下后的每次移动都重新截图
+        if (mouseEvent && mouseEvent->buttons() == Qt::LeftButton
+                && (mouseEvent->globalPos() - m_dragStartPos).manhattanLength() >= QApplication::startDragDistance())
         {
             if(DockItem *item = qobject_cast<DockItem *>(object)) {
-                QPixmap pixmap = item->grab();
+                QPixmap pixmap = item->itemPixmap();
                 QDrag *drag = new QDrag(item);
                 drag->setPixmap(pixmap);
 
@@ -156,4 +166,33 @@ bool AppDirWidget::eventFilter(QObject* object, QEvent* event)
         }
     }
     return QWidget::eventFilter(object, event);
-}
\ No newline at end of file
+}
+
+// 在弹窗内拖动应用调整顺序
+void AppDirWidget::dragEnterEvent(QDragEnterEvent *e)
+{
+    if(m_items.contains(qobject_cast<AppItem *>(e->source())))
+        e->acceptProposedAction();
+}
+
+void AppDirWidget::dragMoveEvent(QDragMoveEvent *e)
+{
+    if(m_items.contains(qobject_cast<AppItem *>(e->source())))
+        e->acceptProposedAction();
+}
+
+void AppDirWidget::dropEvent(QDropEvent *e)
+{
+    const int from = m_items.indexOf(qobject_cast<AppItem *>(e->source()));
+    int to = -1;
+    for(int i = 0; i < m_items.size() && to == -1; ++i)
+        if(m_items.at(i)->geometry().contains(e->pos()))
+            to = i;
+
+    if(from == -1 || to == -1 || from == to)
+        return;
+
+    e->acceptProposedAction();
+    moveAppItem(from, to);
+    emit appItemMoved(from, to);
+}
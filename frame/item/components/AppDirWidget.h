@@ -18,25 +18,34 @@ public:
 
     void addAppItem(AppItem *item);
     void removeAppItem(AppItem *item);
+    void moveAppItem(int from, int to);
     void prepareHide();
 
 protected:
     void enterEvent(QEvent *e) override;
     void leaveEvent(QEvent *e) override;
     bool eventFilter(QObject* object, QEvent* event) override;
+    void dragEnterEvent(QDragEnterEvent *e) override;
+    void dragMoveEvent(QDragMoveEvent *e) override;
+    void dropEvent(QDropEvent *e) override;
 
 private slots:
     void checkMouseLeave();
 
+private:
+    void placeItem(int index);
+
 signals:
     void requestHidePopup();
     void updateTitle(QString title);
+    void appItemMoved(int from, int to);
 
 private:
     QGridLayout *m_Layout;
     QLineEdit *m_TextField;
 
-    int m_row, m_column;
+    QList<AppItem *> m_items;   // 按显示顺序排列，第 i 项位于第 i / 4 行、第 i % 4 列
+    QPoint m_dragStartPos;
 
     QTimer *m_mouseLeaveTimer;
 
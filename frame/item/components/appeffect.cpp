@@ -2,6 +2,8 @@
 
 #include "util/utils.h"
 
+#include <QPixmapCache>
+
 const static qreal Frames[] = { 0,
                                 0.327013,
                                 0.987033,
@@ -63,12 +65,37 @@ const static qreal Frames[] = { 0,
                                 0,
                             };
 
-AppEffect::AppEffect(QWidget *parent, const QPixmap &icon, DockItemManager::ActivateAnimationType type, Position position) : QGraphicsView()
-    , m_parent(parent)
-    , m_icon(icon)
-    , m_position(position)
-    , m_type(type){
-    setWindowFlags(Qt::X11BypassWindowManagerHint | Qt::WindowStaysOnTopHint | Qt::WindowDoesNotAcceptFocus);
+#define MAX_IDLE_EFFECTS 4
+
+namespace {
+struct LatencyStatistics {
+    quint64 count;
+    qint64 total;
+    qint64 max;
+    qint64 last;
+};
+
+LatencyStatistics latencies[DockItemManager::Popup + 1];
+quint64 createdCount = 0;
+quint64 reusedCount = 0;
+quint64 lighterHits = 0;
+quint64 lighterMisses = 0;
+
+QList<AppEffect *> &idleEffects()
+{
+    static QList<AppEffect *> effects;
+    return effects;
+}
+}
+
+AppEffect::AppEffect(bool stayOnBottom) : QGraphicsView()
+    , m_stayOnBottom(stayOnBottom)
+    , m_parent(nullptr)
+    , m_position(Bottom)
+    , m_type(DockItemManager::No)
+    , m_animation(nullptr) {
+    setWindowFlags(Qt::X11BypassWindowManagerHint | Qt::WindowDoesNotAcceptFocus
+                   | (stayOnBottom ? Qt::WindowStaysOnBottomHint : Qt::WindowStaysOnTopHint));
     setAttribute(Qt::WA_TransparentForMouseEvents);
     setAttribute( Qt::WA_TranslucentBackground);
     viewport()->setAutoFillBackground(false);
@@ -84,9 +111,110 @@ AppEffect::AppEffect(QWidget *parent, const QPixmap &icon, DockItemManager::Acti
     m_itemScene = new QGraphicsScene(this);
     setScene(m_itemScene);
 
-    m_item = m_itemScene->addPixmap(Utils::lighterEffect(m_icon));
+    m_item = m_itemScene->addPixmap(QPixmap());
     m_item->setTransformationMode(Qt::SmoothTransformation);
 
+    // 提前创建原生窗口，点击时只需要映射
+    winId();
+    ++createdCount;
+}
+
+/**
+ * @brief AppEffect::preload 预先创建特效窗口放入池中
+ */
+void AppEffect::preload()
+{
+    static bool loaded = false;
+    if (loaded)
+        return;
+    loaded = true;
+
+    QList<AppEffect *> &idle = idleEffects();
+    while (idle.size() < MAX_IDLE_EFFECTS - 1)
+        idle.append(new AppEffect(false));
+    idle.append(new AppEffect(true));
+}
+
+QVariantMap AppEffect::statistics()
+{
+    static const char *names[] = { "swing", "jump", "scale", "popup" };
+
+    QVariantMap result;
+    for (int type = DockItemManager::Swing; type <= DockItemManager::Popup; ++type) {
+        const LatencyStatistics &latency = latencies[type];
+        QVariantMap item;
+        item.insert("count", latency.count);
+        item.insert("lastMs", latency.last);
+        item.insert("maxMs", latency.max);
+        item.insert("averageMs", latency.count ? qreal(latency.total) / latency.count : 0.);
+        result.insert(names[type], item);
+    }
+    result.insert("surfacesCreated", createdCount);
+    result.insert("surfacesReused", reusedCount);
+    result.insert("surfacesIdle", idleEffects().size());
+    result.insert("lighterCacheHits", lighterHits);
+    result.insert("lighterCacheMisses", lighterMisses);
+    return result;
+}
+
+QVariantAnimation *AppEffect::create(QWidget *parent, const QPixmap &icon, DockItemManager::ActivateAnimationType type, Position position)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const bool stayOnBottom = type == DockItemManager::Popup;
+
+    AppEffect *view = nullptr;
+    QList<AppEffect *> &idle = idleEffects();
+    for (int i = 0; i < idle.size(); ++i) {
+        if (idle.at(i)->m_stayOnBottom == stayOnBottom) {
+            view = idle.takeAt(i);
+            ++reusedCount;
+            break;
+        }
+    }
+
+    if (!view)
+        view = new AppEffect(stayOnBottom);
+
+    view->m_latencyTimer = timer;
+    view->setup(parent, icon, type, position);
+    return view->m_animation;
+}
+
+// 图标变亮需要逐像素处理，按图标缓存结果
+QPixmap AppEffect::lighterIcon(const QPixmap &icon)
+{
+    const QString key = QString("AppEffect_lighter_%1").arg(icon.cacheKey());
+
+    QPixmap pixmap;
+    if (QPixmapCache::find(key, &pixmap)) {
+        ++lighterHits;
+        return pixmap;
+    }
+
+    ++lighterMisses;
+    pixmap = Utils::lighterEffect(icon);
+    QPixmapCache::insert(key, pixmap);
+    return pixmap;
+}
+
+void AppEffect::setup(QWidget *parent, const QPixmap &icon, DockItemManager::ActivateAnimationType type, Position position)
+{
+    m_parent = parent;
+    m_icon = icon;
+    m_position = position;
+    m_type = type;
+
+    m_item->setPixmap(lighterIcon(m_icon));
+    setSceneRect(QRectF());
+
+    // 特效窗口随父控件一起回收
+    m_parentDestroyed = connect(m_parent, &QObject::destroyed, this, [this] {
+        m_parent = nullptr;
+        release();
+    });
+
     m_animation = new QVariantAnimation(this);
     m_animation->setDuration(1200);
     m_animation->setLoopCount(1);
@@ -95,7 +223,7 @@ AppEffect::AppEffect(QWidget *parent, const QPixmap &icon, DockItemManager::Acti
             show();
         else if (newState == QVariantAnimation::Stopped) {
             if(m_type != DockItemManager::Popup or m_animation->direction() == QVariantAnimation::Backward)
-                deleteLater();
+                release();
         }
     });
 
@@ -109,6 +237,37 @@ AppEffect::AppEffect(QWidget *parent, const QPixmap &icon, DockItemManager::Acti
         initPopup();
 }
 
+void AppEffect::release()
+{
+    hide();
+
+    disconnect(m_parentDestroyed);
+    if (m_parent)
+        m_parent->removeEventFilter(this);
+    m_parent = nullptr;
+
+    if (m_animation) {
+        disconnect(m_animation, nullptr, this, nullptr);
+        m_animation->deleteLater();
+        m_animation = nullptr;
+    }
+
+    m_icon = QPixmap();
+    m_type = DockItemManager::No;
+    m_item->setPixmap(QPixmap());
+    m_item->setPos(0, 0);
+    m_item->setRotation(0);
+    m_item->setScale(1);
+    m_item->setTransformOriginPoint(0, 0);
+    m_latencyTimer.invalidate();
+
+    QList<AppEffect *> &idle = idleEffects();
+    if (idle.size() < MAX_IDLE_EFFECTS)
+        idle.append(this);
+    else
+        deleteLater();
+}
+
 void AppEffect::initSwing() {
     move(m_parent->mapToGlobal(QPoint(0, 0)));
 
@@ -190,8 +349,6 @@ void AppEffect::initScale() {
 }
 
 void AppEffect::initPopup() {
-    setWindowFlag(Qt::WindowStaysOnBottomHint, true);
-
     const qreal scale = .2;
     const int oldWidth = m_parent->width();
     const int newWidth = oldWidth*(1 + scale);
@@ -233,18 +390,32 @@ void AppEffect::initPopup() {
 
 void AppEffect::enterEvent(QEvent *event) {
     QGraphicsView::enterEvent(event);
-    if(m_type == DockItemManager::Scale)
+    if(m_type == DockItemManager::Scale && m_animation)
         m_animation->setDirection(QVariantAnimation::Forward);
 }
 
 void AppEffect::leaveEvent(QEvent *event) {
     QGraphicsView::leaveEvent(event);
-    if(m_type == DockItemManager::Scale) {
+    if(m_type == DockItemManager::Scale && m_animation) {
         m_animation->setDirection(QVariantAnimation::Backward);
         m_animation->start();
     }
 }
 
+void AppEffect::paintEvent(QPaintEvent *event) {
+    QGraphicsView::paintEvent(event);
+
+    if (m_latencyTimer.isValid() && m_type >= DockItemManager::Swing && m_type <= DockItemManager::Popup) {
+        LatencyStatistics &latency = latencies[m_type];
+        const qint64 elapsed = m_latencyTimer.elapsed();
+        ++latency.count;
+        latency.total += elapsed;
+        latency.last = elapsed;
+        latency.max = qMax(latency.max, elapsed);
+        m_latencyTimer.invalidate();
+    }
+}
+
 bool AppEffect::eventFilter(QObject *object, QEvent *event) {
     if(m_type == DockItemManager::Scale && object == m_parent && event->type() == QEvent::Move)
         move(m_parent->mapToGlobal(QPoint(0, 0)));
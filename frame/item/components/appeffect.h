@@ -7,40 +7,48 @@
 #include <QGraphicsView>
 #include <QGraphicsPixmapItem>
 #include <QVariantAnimation>
+#include <QElapsedTimer>
 
 class AppEffect : public QGraphicsView {
     Q_OBJECT
     public:
         static QVariantAnimation* SwingEffect(QWidget *parent, const QPixmap &icon)
         {
-            AppEffect *view = new AppEffect(parent, icon, DockItemManager::Swing);
-            return view->m_animation;
+            return create(parent, icon, DockItemManager::Swing);
         }
 
         static QVariantAnimation* JumpEffect(QWidget *parent, const QPixmap &icon, Position position)
         {
-            AppEffect *view = new AppEffect(parent, icon, DockItemManager::Jump, position);
-            return view->m_animation;
+            return create(parent, icon, DockItemManager::Jump, position);
         }
 
         static QVariantAnimation* ScaleEffect(QWidget *parent, const QPixmap &icon, Position position)
         {
-            AppEffect *view = new AppEffect(parent, icon, DockItemManager::Scale, position);
-            return view->m_animation;
+            return create(parent, icon, DockItemManager::Scale, position);
         }
 
         static QVariantAnimation* PopupEffect(QWidget *parent, const QPixmap &icon, Position position)
         {
-            AppEffect *view = new AppEffect(parent, icon, DockItemManager::Popup, position);
-            return view->m_animation;
+            return create(parent, icon, DockItemManager::Popup, position);
         }
+
+        static void preload();
+        static QVariantMap statistics();
+
     protected:
         void enterEvent(QEvent *event) override;
         void leaveEvent(QEvent *event) override;
+        void paintEvent(QPaintEvent *event) override;
         bool eventFilter(QObject *object, QEvent *event) override;
 
     private:
-        AppEffect(QWidget *parent, const QPixmap &icon, DockItemManager::ActivateAnimationType type, Position position=Bottom);
+        explicit AppEffect(bool stayOnBottom);
+
+        static QVariantAnimation *create(QWidget *parent, const QPixmap &icon, DockItemManager::ActivateAnimationType type, Position position=Bottom);
+        static QPixmap lighterIcon(const QPixmap &icon);
+
+        void setup(QWidget *parent, const QPixmap &icon, DockItemManager::ActivateAnimationType type, Position position);
+        void release();
 
         void initSwing();
         void initJump();
@@ -48,12 +56,16 @@ class AppEffect : public QGraphicsView {
         void initPopup();
 
 private:
+    // 特效窗口放在池中复用，只有动画对象每次重新创建
+    const bool m_stayOnBottom;
     QWidget *m_parent;
-    const QPixmap m_icon;
-    const Position m_position;
-    const DockItemManager::ActivateAnimationType m_type;
+    QPixmap m_icon;
+    Position m_position;
+    DockItemManager::ActivateAnimationType m_type;
     QGraphicsScene *m_itemScene;
     QGraphicsPixmapItem *m_item;
     QVariantAnimation *m_animation;
+    QMetaObject::Connection m_parentDestroyed;
+    QElapsedTimer m_latencyTimer;   // 从请求动画到第一帧绘制的时间
 };
 #endif /* ifndef SWINGEFFECT */
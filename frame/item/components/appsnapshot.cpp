@@ -21,6 +21,7 @@
 
 #include "appsnapshot.h"
 #include "previewcontainer.h"
+#include "util/thumbnailcache.h"
 
 #include <DStyle>
 
@@ -28,7 +29,6 @@
 #include <X11/X.h>
 #include <X11/Xutil.h>
 #include <X11/Xatom.h>
-#include <sys/shm.h>
 
 #include <QX11Info>
 #include <QPainter>
@@ -36,21 +36,6 @@
 #include <QSizeF>
 #include <QTimer>
 
-struct SHMInfo {
-    long shmid;
-    long width;
-    long height;
-    long bytesPerLine;
-    long format;
-
-    struct Rect {
-        long x;
-        long y;
-        long width;
-        long height;
-    } rect;
-};
-
 AppSnapshot::AppSnapshot(const WId wid, QWidget *parent)
     : QWidget(parent)
     , m_wid(wid)
@@ -85,9 +70,29 @@ AppSnapshot::AppSnapshot(const WId wid, QWidget *parent)
 
     connect(m_closeBtn2D, &DIconButton::clicked, this, &AppSnapshot::closeWindow, Qt::QueuedConnection);
     connect(m_wmHelper, &DWindowManagerHelper::hasCompositeChanged, this, &AppSnapshot::compositeChanged, Qt::QueuedConnection);
+    connect(ThumbnailCache::instance(), &ThumbnailCache::thumbnailChanged, this, &AppSnapshot::onSnapshotReady);
+    connect(ThumbnailCache::instance(), &ThumbnailCache::thumbnailFailed, this, [this](const WId wid) {
+        if (wid == m_wid)
+            emit requestCheckWindow();
+    });
     QTimer::singleShot(1, this, &AppSnapshot::compositeChanged);
 }
 
+// 预览列表滚动时复用控件，切换到另一个窗口
+void AppSnapshot::setWid(const WId wid)
+{
+    if (wid == m_wid)
+        return;
+
+    m_wid = wid;
+    m_snapshot = QImage();
+    m_snapshotSrcRect = QRectF();
+    m_snapshotSize = QSize();
+
+    update();
+    emit snapshotChanged();
+}
+
 void AppSnapshot::setCloseAble(const bool value) {
     m_closeAble = value;
 }
@@ -140,66 +145,24 @@ void AppSnapshot::fetchSnapshot()
     if (!m_wmHelper->hasComposite())
         return;
 
-    QImage qimage;
-    SHMInfo *info = nullptr;
-    uchar *image_data = nullptr;
-    XImage *ximage = nullptr;
-    unsigned char *prop_to_return_gtk = nullptr;
-
-    do {
-        // get window image from shm(only for deepin app)
-        info = getImageDSHM();
-        if (info) {
-            qDebug() << "get Image from dxcbplugin SHM...";
-            //qDebug() << info->shmid << info->width << info->height << info->bytesPerLine << info->format << info->rect.x << info->rect.y << info->rect.width << info->rect.height;
-            image_data = (uchar *)shmat(info->shmid, 0, 0);
-            if ((qint64)image_data != -1) {
-                m_snapshot = QImage(image_data, info->width, info->height, info->bytesPerLine, (QImage::Format)info->format);
-                m_snapshotSrcRect = QRect(info->rect.x, info->rect.y, info->rect.width, info->rect.height);
-                break;
-            }
-            qDebug() << "invalid pointer of shm!";
-            image_data = nullptr;
-        }
-
-        if (!image_data || qimage.isNull()) {
-            // get window image from XGetImage(a little slow)
-            qDebug() << "get Image from dxcbplugin SHM failed!";
-            qDebug() << "get Image from Xlib...";
-            ximage = getImageXlib();
-            if (!ximage) {
-                qDebug() << "get Image from Xlib failed! giving up...";
-                emit requestCheckWindow();
-                return;
-            }
-            qimage = QImage((const uchar *)(ximage->data), ximage->width, ximage->height, ximage->bytes_per_line, QImage::Format_RGB32);
-        }
+    const auto ratio = devicePixelRatioF();
+    m_snapshotSize = rect().marginsRemoved(QMargins(8, 8, 8, 8)).size() * ratio;
 
-        Q_ASSERT(!qimage.isNull());
+    const QImage image = ThumbnailCache::instance()->thumbnail(m_wid, m_snapshotSize, ratio, SnapshotCapturer::Visible);
+    if (!image.isNull())
+        onSnapshotReady(m_wid, m_snapshotSize, image);
+}
 
-        // remove shadow frame
-        m_snapshotSrcRect = rectRemovedShadow(qimage, prop_to_return_gtk);
-        m_snapshot = qimage;
-    } while (false);
+void AppSnapshot::onSnapshotReady(const WId wid, const QSize &size, const QImage &image)
+{
+    if (wid != m_wid || size != m_snapshotSize || image.cacheKey() == m_snapshot.cacheKey())
+        return;
 
-    QSizeF size(rect().marginsRemoved(QMargins(8, 8, 8, 8)).size());
-    const auto ratio = devicePixelRatioF();
-    size = m_snapshotSrcRect.size().scaled(size * ratio, Qt::KeepAspectRatio);
-    qreal scale = qreal(size.width()) / m_snapshotSrcRect.width();
-    m_snapshot = m_snapshot.scaled(qRound(m_snapshot.width() * scale), qRound(m_snapshot.height() * scale),
-                                   Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-    m_snapshotSrcRect.moveTop(m_snapshotSrcRect.top() * scale + 0.5);
-    m_snapshotSrcRect.moveLeft(m_snapshotSrcRect.left() * scale + 0.5);
-    m_snapshotSrcRect.setWidth(size.width() - 0.5);
-    m_snapshotSrcRect.setHeight(size.height() - 0.5);
-    m_snapshot.setDevicePixelRatio(ratio);
-
-    if (image_data) shmdt(image_data);
-    if (ximage) XDestroyImage(ximage);
-    if (info) XFree(info);
-    if (prop_to_return_gtk) XFree(prop_to_return_gtk);
+    m_snapshot = image;
+    m_snapshotSrcRect = QRectF(0, 0, image.width() - 0.5, image.height() - 0.5);
 
     update();
+    emit snapshotChanged();
 }
 
 void AppSnapshot::enterEvent(QEvent *e)
@@ -268,7 +231,7 @@ void AppSnapshot::resizeEvent(QResizeEvent *e)
 {
     QWidget::resizeEvent(e);
 
-    QTimer::singleShot(1, this, &AppSnapshot::fetchSnapshot);
+    fetchSnapshot();
 }
 
 void AppSnapshot::mousePressEvent(QMouseEvent *e)
@@ -292,65 +255,3 @@ bool AppSnapshot::eventFilter(QObject *watched, QEvent *e)
 
     return QWidget::eventFilter(watched, e);
 }
-
-SHMInfo *AppSnapshot::getImageDSHM()
-{
-    const auto display = QX11Info::display();
-
-    Atom atom_prop = XInternAtom(display, "_DEEPIN_DXCB_SHM_INFO", true);
-    if (!atom_prop) {
-        return nullptr;
-    }
-
-    Atom actual_type_return_deepin_shm;
-    int actual_format_return_deepin_shm;
-    unsigned long nitems_return_deepin_shm;
-    unsigned long bytes_after_return_deepin_shm;
-    unsigned char *prop_return_deepin_shm;
-
-    XGetWindowProperty(display, m_wid, atom_prop, 0, 32 * 9, false, AnyPropertyType,
-                       &actual_type_return_deepin_shm, &actual_format_return_deepin_shm, &nitems_return_deepin_shm,
-                       &bytes_after_return_deepin_shm, &prop_return_deepin_shm);
-
-    //qDebug() << actual_type_return_deepin_shm << actual_format_return_deepin_shm << nitems_return_deepin_shm << bytes_after_return_deepin_shm << prop_return_deepin_shm;
-
-    return reinterpret_cast<SHMInfo *>(prop_return_deepin_shm);
-}
-
-XImage *AppSnapshot::getImageXlib()
-{
-    const auto display = QX11Info::display();
-    Window unused_window;
-    int unused_int;
-    unsigned unused_uint, w, h;
-    XGetGeometry(display, m_wid, &unused_window, &unused_int, &unused_int, &w, &h, &unused_uint, &unused_uint);
-    return XGetImage(display, m_wid, 0, 0, w, h, AllPlanes, ZPixmap);
-}
-
-QRect AppSnapshot::rectRemovedShadow(const QImage &qimage, unsigned char *prop_to_return_gtk)
-{
-    const auto display = QX11Info::display();
-
-    const Atom gtk_frame_extents = XInternAtom(display, "_GTK_FRAME_EXTENTS", true);
-    Atom actual_type_return_gtk;
-    int actual_format_return_gtk;
-    unsigned long n_items_return_gtk;
-    unsigned long bytes_after_return_gtk;
-
-    const auto r = XGetWindowProperty(display, m_wid, gtk_frame_extents, 0, 4, false, XA_CARDINAL,
-                                      &actual_type_return_gtk, &actual_format_return_gtk, &n_items_return_gtk, &bytes_after_return_gtk, &prop_to_return_gtk);
-    if (!r && prop_to_return_gtk && n_items_return_gtk == 4 && actual_format_return_gtk == 32) {
-        qDebug() << "remove shadow frame...";
-        const unsigned long *extents = reinterpret_cast<const unsigned long *>(prop_to_return_gtk);
-        const int left = extents[0];
-        const int right = extents[1];
-        const int top = extents[2];
-        const int bottom = extents[3];
-        const int width = qimage.width();
-        const int height = qimage.height();
-
-        return QRect(left, top, width - left - right, height - top - bottom);
-    } else {
-        return QRect(0, 0, qimage.width(), qimage.height());
-    }
-}
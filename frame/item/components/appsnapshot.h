@@ -37,10 +37,6 @@ DGUI_USE_NAMESPACE
 #define SNAP_WIDTH       200
 #define SNAP_HEIGHT      130
 
-struct SHMInfo;
-struct _XImage;
-typedef _XImage XImage;
-
 class AppSnapshot : public QWidget
 {
     Q_OBJECT
@@ -49,6 +45,7 @@ public:
     explicit AppSnapshot(const WId wid, QWidget *parent = 0);
 
     inline WId wid() const { return m_wid; }
+    void setWid(const WId wid);
     inline bool attentioned() { return m_windowInfo.attention; }
     inline bool closeAble() const { return m_closeAble; }
     void setCloseAble(const bool value);
@@ -60,6 +57,7 @@ signals:
     void entered(const WId wid) const;
     void clicked(const WId wid) const;
     void requestCheckWindow() const;
+    void snapshotChanged() const;
 
 public slots:
     void fetchSnapshot();
@@ -75,18 +73,19 @@ private:
     void resizeEvent(QResizeEvent *e) override;
     void mousePressEvent(QMouseEvent *e) override;
     bool eventFilter(QObject *watched, QEvent *e) override;
-    SHMInfo *getImageDSHM();
-    XImage * getImageXlib();
-    QRect rectRemovedShadow(const QImage &qimage, unsigned char *prop_to_return_gtk);
+
+private slots:
+    void onSnapshotReady(const WId wid, const QSize &size, const QImage &image);
 
 private:
-    const WId m_wid;
+    WId m_wid;
     WindowInfo m_windowInfo;
 
     bool m_closeAble;
 
     QImage m_snapshot;
     QRectF m_snapshotSrcRect;
+    QSize m_snapshotSize;
 
     TipsWidget *m_title;
     QTimer *m_waitLeaveTimer;
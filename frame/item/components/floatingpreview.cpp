@@ -86,12 +86,17 @@ AppSnapshot *FloatingPreview::trackedWindow()
 
 void FloatingPreview::trackWindow(AppSnapshot *const snap)
 {
-    if (!m_tracked.isNull())
+    if (!m_tracked.isNull()) {
         m_tracked->removeEventFilter(this);
+        disconnect(m_tracked, &AppSnapshot::snapshotChanged, this, nullptr);
+    }
 
     snap->installEventFilter(this);
     m_tracked = snap;
 
+    // 预览图在截图线程中异步生成，到达后需要重绘
+    connect(m_tracked, &AppSnapshot::snapshotChanged, this, [this] { update(); });
+
     m_closeBtn3D->setVisible(m_tracked->closeAble());
 
     QFontMetrics fm(m_titleBtn->font());
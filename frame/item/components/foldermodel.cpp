@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "foldermodel.h"
+
+#include <QDir>
+#include <QFileIconProvider>
+#include <QMimeData>
+#include <QMimeDatabase>
+#include <QUrl>
+
+#include <algorithm>
+
+FolderModel::FolderModel(const QString &path, QObject *parent) : QAbstractListModel(parent)
+    , m_path(path)
+{
+}
+
+/**
+ * @brief FolderModel::scan 在线程池中列出目录并解析 MIME 图标，上次已解析过的文件直接复用
+ */
+QVector<FolderEntry> FolderModel::scan(const QString &path, const QHash<QString, FolderEntry> &known)
+{
+    static QMimeDatabase mimeDatabase;
+
+    QVector<FolderEntry> entries;
+    const QFileInfoList infos = QDir(path).entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+    entries.reserve(infos.size());
+
+    for (const QFileInfo &info : infos) {
+        FolderEntry entry = known.value(info.fileName());
+        if (entry.name.isEmpty() || (entry.iconName == "folder") != info.isDir()) {
+            entry.name = info.fileName();
+            if (info.isDir()) {
+                entry.iconName = "folder";
+                entry.genericIconName.clear();
+            } else {
+                const QMimeType mime = mimeDatabase.mimeTypeForFile(info, QMimeDatabase::MatchExtension);
+                entry.iconName = mime.iconName();
+                entry.genericIconName = mime.genericIconName();
+            }
+        }
+        entries.append(entry);
+    }
+
+    return entries;
+}
+
+int FolderModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_entries.size();
+}
+
+QVariant FolderModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.size())
+        return QVariant();
+
+    const FolderEntry &entry = m_entries.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::ToolTipRole:
+        return entry.name;
+    case Qt::DecorationRole:
+        return QVariant::fromValue(icon(entry));
+    case FilePathRole:
+        return m_path + '/' + entry.name;
+    default:
+        return QVariant();
+    }
+}
+
+Qt::ItemFlags FolderModel::flags(const QModelIndex &index) const
+{
+    return index.isValid() ? Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsDragEnabled : Qt::NoItemFlags;
+}
+
+QStringList FolderModel::mimeTypes() const
+{
+    return QStringList("text/uri-list");
+}
+
+QMimeData *FolderModel::mimeData(const QModelIndexList &indexes) const
+{
+    QMimeData *data = new QMimeData();
+    QList<QUrl> urls;
+    for (const QModelIndex &index : indexes)
+        urls << QUrl::fromLocalFile(index.data(FilePathRole).toString());
+
+    data->setUrls(urls);
+    return data;
+}
+
+/**
+ * @brief FolderModel::update 与新的目录内容比较，只删除和插入变化的行，连续的行合并为一次通知
+ */
+void FolderModel::update(const QVector<FolderEntry> &entries)
+{
+    QHash<QString, FolderEntry> known;
+    known.reserve(entries.size());
+    for (const FolderEntry &entry : entries)
+        known.insert(entry.name, entry);
+
+    for (int row = m_entries.size() - 1; row >= 0; --row) {
+        if (known.contains(m_entries.at(row).name))
+            continue;
+
+        int first = row;
+        while (first > 0 && !known.contains(m_entries.at(first - 1).name))
+            --first;
+
+        beginRemoveRows(QModelIndex(), first, row);
+        m_entries.erase(m_entries.begin() + first, m_entries.begin() + row + 1);
+        endRemoveRows();
+        row = first;
+    }
+
+    // 保留下来的行顺序应与新列表一致，否则（例如排序规则变化）直接重置
+    int survivor = 0;
+    for (const FolderEntry &entry : entries) {
+        if (!m_known.contains(entry.name))
+            continue;
+        if (survivor >= m_entries.size() || m_entries.at(survivor).name != entry.name) {
+            beginResetModel();
+            m_entries = entries;
+            m_known.swap(known);
+            endResetModel();
+            return;
+        }
+        ++survivor;
+    }
+
+    for (int row = 0; row < entries.size(); ++row) {
+        if (row < m_entries.size() && m_entries.at(row).name == entries.at(row).name) {
+            if (m_entries.at(row).iconName != entries.at(row).iconName) {
+                m_entries[row] = entries.at(row);
+                emit dataChanged(index(row), index(row), {Qt::DecorationRole});
+            }
+            continue;
+        }
+
+        const QString next = row < m_entries.size() ? m_entries.at(row).name : QString();
+        int last = row;
+        while (last + 1 < entries.size() && entries.at(last + 1).name != next)
+            ++last;
+
+        beginInsertRows(QModelIndex(), row, last);
+        m_entries.insert(row, last - row + 1, FolderEntry());
+        std::copy(entries.begin() + row, entries.begin() + last + 1, m_entries.begin() + row);
+        endInsertRows();
+        row = last;
+    }
+
+    m_known.swap(known);
+}
+
+QIcon FolderModel::icon(const FolderEntry &entry) const
+{
+    static QFileIconProvider provider;
+
+    auto it = m_icons.find(entry.iconName);
+    if (it == m_icons.end()) {
+        QIcon icon = QIcon::fromTheme(entry.iconName);
+        if (icon.isNull())
+            icon = QIcon::fromTheme(entry.genericIconName, provider.icon(QFileIconProvider::File));
+        it = m_icons.insert(entry.iconName, icon);
+    }
+    return it.value();
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef FOLDERMODEL_H
+#define FOLDERMODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QIcon>
+#include <QVector>
+
+struct FolderEntry {
+    QString name;
+    QString iconName;
+    QString genericIconName;
+};
+
+/**
+ * @brief The FolderModel class
+ * 文件夹弹窗的数据模型，目录在线程池中扫描，主线程只比较结果并更新变化的行
+ */
+class FolderModel : public QAbstractListModel {
+    Q_OBJECT
+public:
+    enum { FilePathRole = Qt::UserRole + 1 };
+
+    FolderModel(const QString &path, QObject *parent = nullptr);
+
+    static QVector<FolderEntry> scan(const QString &path, const QHash<QString, FolderEntry> &known);
+
+    const QHash<QString, FolderEntry> &known() const { return m_known; }
+    void update(const QVector<FolderEntry> &entries);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    QStringList mimeTypes() const override;
+    QMimeData *mimeData(const QModelIndexList &indexes) const override;
+
+private:
+    QIcon icon(const FolderEntry &entry) const;
+
+private:
+    const QString m_path;
+    QVector<FolderEntry> m_entries;
+    QHash<QString, FolderEntry> m_known;
+    mutable QHash<QString, QIcon> m_icons;
+};
+
+#endif // FOLDERMODEL_H
@@ -25,6 +25,7 @@
 #include <QScreen>
 #include <QApplication>
 #include <QDragEnterEvent>
+#include <QWheelEvent>
 
 #define SPACING           0
 #define MARGIN            0
@@ -47,6 +48,8 @@ PreviewContainer *PreviewContainer::instance(const WindowInfoMap &infos, const Q
 
 PreviewContainer::PreviewContainer() : QWidget(),
     m_needActivate(false),
+    m_firstIndex(0),
+    m_overflowTips(new TipsWidget(this)),
     m_floatingPreview(new FloatingPreview(this)),
     m_mouseLeaveTimer(new QTimer(this)),
     m_wmHelper(DWindowManagerHelper::instance())
@@ -59,6 +62,7 @@ PreviewContainer::PreviewContainer() : QWidget(),
     m_mouseLeaveTimer->setInterval(300);
 
     m_floatingPreview->setVisible(false);
+    m_overflowTips->setVisible(false);
 
     m_waitForShowPreviewTimer = new QTimer(this);
     m_waitForShowPreviewTimer->setSingleShot(true);
@@ -74,39 +78,22 @@ PreviewContainer::PreviewContainer() : QWidget(),
 
 void PreviewContainer::setWindowInfos(const WindowInfoMap &infos, const QVector<uint> allowClose)
 {
-    // check removed window
-    for (auto it(m_snapshots.begin()); it != m_snapshots.end();)
-    {
-        if (!infos.contains(it.key()))
-        {
-            m_windowListLayout->removeWidget(it.value());
-            it.value()->deleteLater();
-            it = m_snapshots.erase(it);
-        } else {
-            ++it;
-        }
-    }
-
-    for (auto it(infos.cbegin()); it != infos.cend(); ++it)
-    {
-        const WId key = it.key();
-        if (!m_snapshots.contains(key))
-            appendSnapWidget(key);
-        m_snapshots[key]->setWindowInfo(it.value());
-        m_snapshots[key]->setCloseAble(allowClose.contains(key));//qInfo()<<"previewclose wId: " << key << ", closeable: " << allowClose;
-    }
+    m_windowInfos = infos;
+    m_windows = infos.keys();
+    m_allowClose = allowClose;
 
-    if (m_snapshots.isEmpty())
+    if (m_windows.isEmpty())
     {
         emit requestCancelPreviewWindow();
         emit requestHidePopup();
     }
     adjustSize();
+    bindSlots();
 }
 
 void PreviewContainer::updateSnapshots()
 {
-    for (AppSnapshot *snap : m_snapshots)
+    for (AppSnapshot *snap : m_slots)
         snap->fetchSnapshot();
 }
 
@@ -118,6 +105,7 @@ void PreviewContainer::updateLayoutDirection(const Dock::Position dockPos)
         m_windowListLayout->setDirection(QBoxLayout::TopToBottom);
 
     adjustSize();
+    bindSlots();
 }
 
 void PreviewContainer::checkMouseLeave()
@@ -148,7 +136,12 @@ void PreviewContainer::prepareHide()
 
 void PreviewContainer::adjustSize()
 {
-    const int count = m_snapshots.size();
+    const int count = std::min(m_windows.size(), slotCapacity());
+    while (m_slots.size() < count)
+        appendSnapWidget();
+    while (m_slots.size() > count)
+        removeSnapWidget();
+
     const bool composite = m_wmHelper->hasComposite();
     if (!composite)
     {
@@ -157,29 +150,41 @@ void PreviewContainer::adjustSize()
         return;
     }
 
-    const QRect r = qApp->primaryScreen()->geometry();
-    const int padding = 20;
-
     const bool horizontal = m_windowListLayout->direction() == QBoxLayout::LeftToRight;
     if (horizontal)
     {
         const int h = SNAP_HEIGHT + MARGIN * 2;
         const int w = SNAP_WIDTH * count + MARGIN * 2 + SPACING * (count - 1);
 
-        setFixedHeight(h);
-        setFixedWidth(std::min(w, r.width() - padding));
+        setFixedSize(w, h);
     } else {
         const int w = SNAP_WIDTH + MARGIN * 2;
         const int h = SNAP_HEIGHT * count + MARGIN * 2 + SPACING * (count - 1);
 
-        setFixedWidth(w);
-        setFixedHeight(std::min(h, r.height() - padding));
+        setFixedSize(w, h);
     }
 }
 
-void PreviewContainer::appendSnapWidget(const WId wid)
+/**
+ * @brief PreviewContainer::slotCapacity 屏幕上最多能放下的预览数量，窗口更多时滚动显示
+ */
+int PreviewContainer::slotCapacity() const
+{
+    const QRect r = qApp->primaryScreen()->geometry();
+    const int padding = 20;
+
+    if (!m_wmHelper->hasComposite())
+        return std::max(1, (r.height() - padding - MARGIN * 2 + SPACING) / (SNAP_HEIGHT_WITHOUT_COMPOSITE + SPACING));
+
+    if (m_windowListLayout->direction() == QBoxLayout::LeftToRight)
+        return std::max(1, (r.width() - padding - MARGIN * 2 + SPACING) / (SNAP_WIDTH + SPACING));
+
+    return std::max(1, (r.height() - padding - MARGIN * 2 + SPACING) / (SNAP_HEIGHT + SPACING));
+}
+
+void PreviewContainer::appendSnapWidget()
 {
-    AppSnapshot *snap = new AppSnapshot(wid);
+    AppSnapshot *snap = new AppSnapshot(0);
 
     connect(snap, &AppSnapshot::clicked, this, &PreviewContainer::onSnapshotClicked, Qt::QueuedConnection);
     connect(snap, &AppSnapshot::entered, this, &PreviewContainer::previewEntered, Qt::QueuedConnection);
@@ -187,11 +192,67 @@ void PreviewContainer::appendSnapWidget(const WId wid)
 
     m_windowListLayout->addWidget(snap);
 
-    m_snapshots.insert(wid, snap);
+    m_slots.append(snap);
+}
 
-    // refresh if visible
-    if (isVisible())
-        snap->fetchSnapshot();
+void PreviewContainer::removeSnapWidget()
+{
+    AppSnapshot *snap = m_slots.takeLast();
+    if (m_floatingPreview->trackedWindow() == snap)
+        m_floatingPreview->setVisible(false);
+
+    m_windowListLayout->removeWidget(snap);
+    snap->deleteLater();
+}
+
+/**
+ * @brief PreviewContainer::bindSlots 把当前滚动位置的窗口绑定到预览控件上，
+ * 只有换了窗口的控件才会重新截图
+ */
+void PreviewContainer::bindSlots()
+{
+    m_firstIndex = qBound(0, m_firstIndex, std::max(0, m_windows.size() - m_slots.size()));
+
+    for (int i = 0; i < m_slots.size(); ++i) {
+        AppSnapshot *snap = m_slots.at(i);
+        const WId wid = m_windows.at(m_firstIndex + i);
+        const bool changed = snap->wid() != wid;
+
+        snap->setWid(wid);
+        snap->setWindowInfo(m_windowInfos.value(wid));
+        snap->setCloseAble(m_allowClose.contains(wid));
+
+        if (changed && isVisible())
+            snap->fetchSnapshot();
+    }
+
+    // 悬浮预览跟随的控件换了窗口时，同步预览的窗口
+    AppSnapshot *tracked = m_floatingPreview->trackedWindow();
+    if (tracked && m_floatingPreview->isVisible() && tracked->wid() != m_currentWId) {
+        m_currentWId = tracked->wid();
+        m_floatingPreview->trackWindow(tracked);
+        emit requestPreviewWindow(m_currentWId);
+    }
+
+    const bool overflow = m_windows.size() > m_slots.size();
+    m_overflowTips->setVisible(overflow);
+    if (overflow) {
+        m_overflowTips->setText(QString("%1-%2/%3").arg(m_firstIndex + 1).arg(m_firstIndex + m_slots.size()).arg(m_windows.size()));
+        m_overflowTips->move(width() - m_overflowTips->width() - 5, height() - m_overflowTips->height() - 5);
+        m_overflowTips->raise();
+        if (m_floatingPreview->isVisible())
+            m_floatingPreview->raise();
+    }
+}
+
+void PreviewContainer::scrollTo(int index)
+{
+    index = qBound(0, index, std::max(0, m_windows.size() - m_slots.size()));
+    if (index == m_firstIndex)
+        return;
+
+    m_firstIndex = index;
+    bindSlots();
 }
 
 void PreviewContainer::enterEvent(QEvent *e)
@@ -232,6 +293,23 @@ void PreviewContainer::dragLeaveEvent(QDragLeaveEvent *e)
     m_mouseLeaveTimer->start();
 }
 
+void PreviewContainer::wheelEvent(QWheelEvent *e)
+{
+    const int delta = e->angleDelta().y() ? e->angleDelta().y() : e->angleDelta().x();
+    if (delta == 0 || m_windows.size() <= m_slots.size())
+        return QWidget::wheelEvent(e);
+
+    scrollTo(m_firstIndex + (delta > 0 ? -1 : 1));
+    e->accept();
+}
+
+void PreviewContainer::resizeEvent(QResizeEvent *e)
+{
+    QWidget::resizeEvent(e);
+
+    m_overflowTips->move(width() - m_overflowTips->width() - 5, height() - m_overflowTips->height() - 5);
+}
+
 void PreviewContainer::onSnapshotClicked(const WId wid)
 {
     if (!m_wmHelper->hasComposite()) {
@@ -30,6 +30,7 @@
 #include "../../taskmanager/windowinfomap.h"
 #include "appsnapshot.h"
 #include "floatingpreview.h"
+#include "../tipswidget.h"
 
 #include <DWindowManagerHelper>
 
@@ -62,12 +63,18 @@ public slots:
 private:
     explicit PreviewContainer();
     void adjustSize();
-    void appendSnapWidget(const WId wid);
+    void appendSnapWidget();
+    void removeSnapWidget();
+    int slotCapacity() const;
+    void bindSlots();
+    void scrollTo(int index);
 
     void enterEvent(QEvent *e);
     void leaveEvent(QEvent *e);
     void dragEnterEvent(QDragEnterEvent *e);
     void dragLeaveEvent(QDragLeaveEvent *e);
+    void wheelEvent(QWheelEvent *e);
+    void resizeEvent(QResizeEvent *e);
 
 private slots:
     void onSnapshotClicked(const WId wid);
@@ -76,7 +83,13 @@ private slots:
 
 private:
     bool m_needActivate;
-    QMap<WId, AppSnapshot *> m_snapshots;
+    QList<WId> m_windows;
+    WindowInfoMap m_windowInfos;
+    QVector<uint> m_allowClose;
+    // 只为可见的位置创建预览控件，滚动时复用，m_firstIndex 为第一个位置对应的窗口
+    QList<AppSnapshot *> m_slots;
+    int m_firstIndex;
+    TipsWidget *m_overflowTips;
 
     FloatingPreview *m_floatingPreview;
     QBoxLayout *m_windowListLayout;
@@ -34,6 +34,10 @@ DirItem::DirItem(QString title, QWidget *parent) : DockItem(parent)
         }
     });
     connect(m_popupGrid, &AppDirWidget::requestHidePopup, this, &DirItem::hideDirpopupWindow);
+    connect(m_popupGrid, &AppDirWidget::appItemMoved, this, [ this ](int from, int to){
+        m_appList.move(from, to);
+        invalidateComposite();
+    });
 }
 
 void DirItem::setIds(QSet<QString> ids)
@@ -71,7 +75,7 @@ void DirItem::addItem(AppItem *appItem)
     m_popupGrid->addAppItem(appItem);
     m_ids.insert(appItem->getDesktopFile());
     appItem->setDirItem(this);
-    update();
+    invalidateComposite();
 }
 
 void DirItem::removeItem(AppItem *appItem, bool removeId)
@@ -81,12 +85,7 @@ void DirItem::removeItem(AppItem *appItem, bool removeId)
     if(removeId)
         m_ids.remove(appItem->getDesktopFile());
     appItem->removeDirItem();
-    update();
-}
-
-void DirItem::rerender(AppItem *appItem)
-{
-    m_popupGrid->addAppItem(appItem);
+    invalidateComposite();
 }
 
 bool DirItem::isEmpty()
@@ -124,13 +123,36 @@ AppItem *DirItem::lastItem()
     return m_appList.isEmpty() ? nullptr : m_appList.last();
 }
 
-void DirItem::paintEvent(QPaintEvent *e)
+void DirItem::paintItem(QPainter &painter)
 {
     if(isScaling()) return ;
 
-    DockItem::paintEvent(e);
+    const auto ratio = devicePixelRatioF();
+    if(m_composite.isNull() || m_composite.size() != size() * ratio || !qFuzzyCompare(m_composite.devicePixelRatio(), ratio)
+            || m_compositeTheme != QIcon::themeName())
+        updateComposite();
+
+    painter.drawPixmap(0, 0, m_composite);
+}
+
+void DirItem::invalidateComposite()
+{
+    m_composite = QPixmap();
+    update();
+}
+
+// 子项增删或图标变化时才重新合成
+void DirItem::updateComposite()
+{
+    const auto ratio = devicePixelRatioF();
+    m_composite = QPixmap(size() * ratio);
+    m_composite.setDevicePixelRatio(ratio);
+    m_composite.fill(Qt::transparent);
+    m_compositeTheme = QIcon::themeName();
+
+    QPainter painter(&m_composite);
+    DockItem::paintItem(painter);
 
-    QPainter painter(this);
     painter.setPen(QPen(Qt::darkCyan, 2));
     // painter.setOpacity(.7);
 
@@ -34,8 +34,6 @@ public:
     void addItem(AppItem *appItem);
     void removeItem(AppItem *appItem, bool removeId = true);
 
-    void rerender(AppItem *appItem);
-
     bool isEmpty();
     QList<AppItem *> getAppList();
     AppItem *firstItem();
@@ -44,7 +42,7 @@ public:
     Place getPlace() override { return DockPlace; }
 
 protected:
-    void paintEvent(QPaintEvent *e) override;
+    void paintItem(QPainter &painter) override;
     void leaveEvent(QEvent *e) override;
     void mouseReleaseEvent(QMouseEvent *e) override;
     void dragEnterEvent(QDragEnterEvent *e) override;
@@ -57,6 +55,10 @@ protected:
 public slots:
     void hideDirpopupWindow();
 
+private:
+    void invalidateComposite();
+    void updateComposite();
+
 signals:
     void updateContent();
 
@@ -67,6 +69,9 @@ private:
     QSet<QString> m_ids;
     QList<AppItem *> m_appList;
 
+    QPixmap m_composite;        // 边框和前四个应用图标合成后的缓存，绘制时直接贴图
+    QString m_compositeTheme;
+
     friend class AppItem;
 };
 
@@ -25,10 +25,14 @@
 #include "../window/dockitemmanager.h"
 #include "components/hoverhighlighteffect.h"
 #include "components/appeffect.h"
+#include "util/animationclock.h"
+#include "util/perfstatistics.h"
+#include "util/utils.h"
 
 #include <QMouseEvent>
 #include <QJsonObject>
 #include <QCursor>
+#include <QPixmapCache>
 
 Position DockItem::DockPosition = Position::Top;
 static DockPopupWindow *PopupWindow(nullptr);
@@ -36,6 +40,7 @@ static DockPopupWindow *PopupWindow(nullptr);
 DockItem::DockItem(QWidget *parent) : QWidget(parent)
     , m_popupTipsDelayTimer(new QTimer(this))
     , m_animation(nullptr)
+    , m_paintedBySurface(false)
 {
     if (!PopupWindow) {
         PopupWindow = new DockPopupWindow(nullptr);
@@ -55,7 +60,7 @@ DockItem::DockItem(QWidget *parent) : QWidget(parent)
         setGraphicsEffect(new HoverHighlightEffect(this));
 
     connect(DockItemManager::instance(), &DockItemManager::hoverHighlighted, this, [this](const bool enabled){
-        setGraphicsEffect(enabled ? new HoverHighlightEffect(this) : nullptr);
+        setGraphicsEffect(enabled && !m_paintedBySurface ? new HoverHighlightEffect(this) : nullptr);
     });
 
     connect(m_popupTipsDelayTimer, &QTimer::timeout, this, &DockItem::showHoverTips);
@@ -74,9 +79,16 @@ DockItem::~DockItem()
 
 void DockItem::paintEvent(QPaintEvent *e)
 {
-    if(m_icon.isNull() || m_animation) return;
+    if(m_paintedBySurface) return;
 
+    PERF_SCOPE("paint", metaObject()->className());
     QPainter painter(this);
+    paintItem(painter);
+}
+
+void DockItem::paintItem(QPainter &painter)
+{
+    if(m_icon.isNull() || m_animation) return;
 
     QPixmap pixmap = m_icon.pixmap(width() *.9);
 
@@ -87,6 +99,96 @@ void DockItem::paintEvent(QPaintEvent *e)
     painter.drawPixmap(iconX, iconY, pixmap);
 }
 
+void DockItem::setPaintedBySurface(const bool painted)
+{
+    if(m_paintedBySurface == painted) return;
+
+    m_paintedBySurface = painted;
+    // 高亮效果需要离屏绘制控件本身，统一绘制时改由 MainPanelControl 处理
+    setGraphicsEffect(!painted && DockItemManager::instance()->isEnableHoverHighlight() ? new HoverHighlightEffect(this) : nullptr);
+    // 面板转发过来的鼠标事件被忽略时不再传回面板
+    setAttribute(Qt::WA_NoMousePropagation, painted);
+    update();
+}
+
+/**
+ * @brief DockItem::isVisibleOnDock 统一绘制时控件本身是隐藏的，以所在面板是否显示为准
+ */
+bool DockItem::isVisibleOnDock() const
+{
+    if(m_paintedBySurface)
+        return parentWidget() && parentWidget()->isVisible();
+
+    return isVisible();
+}
+
+/**
+ * @brief DockItem::update 统一绘制时重绘面板上对应的区域
+ */
+void DockItem::update()
+{
+    if(m_paintedBySurface && parentWidget())
+        parentWidget()->update(geometry());
+    else
+        QWidget::update();
+}
+
+/**
+ * @brief DockItem::updateOnFrame 在下一帧重绘，同一帧内的多次请求只重绘一次
+ */
+void DockItem::updateOnFrame()
+{
+    if(m_paintedBySurface && parentWidget())
+        AnimationClock::instance()->requestUpdate(parentWidget(), geometry());
+    else
+        AnimationClock::instance()->requestUpdate(this);
+}
+
+QString DockItem::accessibleText()
+{
+    return accessibleName().isEmpty() ? popupTips() : accessibleName();
+}
+
+// 统一绘制时控件自身不绘制，grab() 得到的是空图，这里直接用 paintItem 画出来
+QPixmap DockItem::itemPixmap()
+{
+    if(!m_paintedBySurface) return grab();
+
+    const auto ratio = devicePixelRatioF();
+    QPixmap pixmap(size() * ratio);
+    pixmap.setDevicePixelRatio(ratio);
+    pixmap.fill(Qt::transparent);
+
+    QPainter painter(&pixmap);
+    paintItem(painter);
+    painter.end();
+
+    return pixmap;
+}
+
+/**
+ * @brief DockItem::lighterPixmap 统一绘制时的悬停高亮图，按控件和图标缓存，
+ * 悬停期间的重绘不再逐像素处理，离开时丢弃，下次悬停按当前内容重新生成
+ */
+QPixmap DockItem::lighterPixmap()
+{
+    const QString key = lighterCacheKey();
+
+    QPixmap pixmap;
+    if(QPixmapCache::find(key, &pixmap))
+        return pixmap;
+
+    pixmap = Utils::lighterEffect(itemPixmap());
+    QPixmapCache::insert(key, pixmap);
+    return pixmap;
+}
+
+QString DockItem::lighterCacheKey() const
+{
+    return QString("DockItem_lighter_%1_%2_%3x%4@%5").arg(quintptr(this)).arg(m_icon.cacheKey())
+            .arg(width()).arg(height()).arg(devicePixelRatioF());
+}
+
 void DockItem::mousePressEvent(QMouseEvent *e)
 {
     m_popupTipsDelayTimer->stop();
@@ -108,18 +210,20 @@ void DockItem::enterEvent(QEvent *e)
         if(m_animation)
             m_animation->setDirection(QVariantAnimation::Forward);
         else {
-            m_animation = AppEffect::PopupEffect(this, (m_icon.isNull() || itemType() == Window) ? grab() : m_icon.pixmap(width() *.9), DockPosition);
+            m_animation = AppEffect::PopupEffect(this, (m_icon.isNull() || itemType() == Window) ? itemPixmap() : m_icon.pixmap(width() *.9), DockPosition);
             connect(m_animation, &QVariantAnimation::stateChanged, this, [this](const QVariantAnimation::State newState, const QVariantAnimation::State oldState) {
                 if(newState == QVariantAnimation::Running)
-                    update();
+                    updateOnFrame();
                 else if(newState == QVariantAnimation::Stopped && m_animation->direction() == QVariantAnimation::Backward) {
                     m_animation = nullptr;
-                    update();
+                    updateOnFrame();
                 }
             });
         }
         m_animation->start();
     }
+
+    if(m_paintedBySurface) update();
     return QWidget::enterEvent(e);
 }
 
@@ -127,6 +231,10 @@ void DockItem::leaveEvent(QEvent *e)
 {
     QWidget::leaveEvent(e);
 
+    if(m_paintedBySurface) {
+        QPixmapCache::remove(lighterCacheKey());
+        update();
+    }
     hideNonModel();
     m_popupTipsDelayTimer->stop();
 
@@ -294,13 +402,13 @@ void DockItem::easeIn(bool animation)
 {
     if(animation && DockItemManager::instance()->isEnableInOutAnimation()) {
         if(m_animation) m_animation->stop();
-        m_animation = AppEffect::ScaleEffect(this, (m_icon.isNull() || itemType() == Window) ? grab() : m_icon.pixmap(width() *.9), DockPosition);
+        m_animation = AppEffect::ScaleEffect(this, (m_icon.isNull() || itemType() == Window) ? itemPixmap() : m_icon.pixmap(width() *.9), DockPosition);
         connect(m_animation, &QVariantAnimation::stateChanged, this, [this](const QVariantAnimation::State newState, const QVariantAnimation::State oldState) {
             if(newState == QVariantAnimation::Running)
-                update();
+                updateOnFrame();
             else if(newState == QVariantAnimation::Stopped) {
                 m_animation = nullptr;
-                update();
+                updateOnFrame();
                 emit inoutFinished(true);
             }
         });
@@ -313,14 +421,14 @@ void DockItem::easeOut(bool animation)
 {
     if(animation && DockItemManager::instance()->isEnableInOutAnimation()) {
         if(m_animation) m_animation->stop();
-        m_animation = AppEffect::ScaleEffect(this, (m_icon.isNull() || itemType() == Window) ? grab() : m_icon.pixmap(width() *.9), DockPosition);
+        m_animation = AppEffect::ScaleEffect(this, (m_icon.isNull() || itemType() == Window) ? itemPixmap() : m_icon.pixmap(width() *.9), DockPosition);
         m_animation->setDirection(QAbstractAnimation::Backward);
         connect(m_animation, &QVariantAnimation::stateChanged, this, [this](const QVariantAnimation::State newState, const QVariantAnimation::State oldState) {
             if(newState == QVariantAnimation::Running)
-                update();
+                updateOnFrame();
             else if(newState == QVariantAnimation::Stopped) {
                 m_animation = nullptr;
-                update();
+                updateOnFrame();
                 emit inoutFinished(false);
             }
         });
@@ -29,6 +29,7 @@
 #include <QMenu>
 
 using namespace Dock;
+class QPainter;
 class DockItem : public QWidget
 {
     Q_OBJECT
@@ -60,6 +61,16 @@ public:
     void easeIn(bool animation);
     void easeOut(bool animation);
 
+    void setPaintedBySurface(const bool painted);
+    bool isPaintedBySurface() const { return m_paintedBySurface; }
+    bool isVisibleOnDock() const;
+    using QWidget::update;
+    void update();
+    QString accessibleText();
+    virtual void paintItem(QPainter &painter);
+    QPixmap itemPixmap();
+    QPixmap lighterPixmap();
+
 signals:
     void itemDropped(QObject *destination, const QPoint &dropPoint) const;
     void requestWindowAutoHide(const bool autoHide) const;
@@ -71,6 +82,7 @@ protected:
     void enterEvent(QEvent *e) override;
     void leaveEvent(QEvent *e) override;
 
+    void updateOnFrame();
     const QRect perfectIconRect() const;
     virtual const QPoint popupMarkPoint() ;
     const QPoint topleftPoint() const;
@@ -92,8 +104,12 @@ protected:
     static Position DockPosition;
     QIcon m_icon;
 
+private:
+    QString lighterCacheKey() const;
+
 private:
     QVariantAnimation *m_animation;
+    bool m_paintedBySurface;    // 由 MainPanelControl 统一绘制，自身不再绘制
 };
 
 #endif // DOCKITEM_H
@@ -1,4 +1,5 @@
 #include "folderitem.h"
+#include "components/foldermodel.h"
 
 #include "util/dockpopupwindow.h"
 
@@ -7,179 +8,150 @@
 #include <QClipboard>
 #include <QStyleOption>
 #include <DGuiApplicationHelper>
-#include <QListWidget>
+#include <QListView>
+#include <QStyledItemDelegate>
 #include <QScrollBar>
-#include <QFileIconProvider>
 #include <QFileSystemWatcher>
 #include <QStandardPaths>
+#include <QHelpEvent>
+#include <QMimeData>
+#include <QToolTip>
+#include <QPainter>
+#include <QProcess>
+#include <QTimer>
+#include <QFutureWatcher>
+#include <QtConcurrent>
 
 static DockPopupWindow *dirPopupWindow(nullptr);
-static QFileIconProvider provider;
 
-class FolderWidget;
-class DesktopItemView : public QWidget {
-    Q_OBJECT
+// 直接绘制图标和文件名，不再为每个文件创建控件和样式表
+class FolderItemDelegate : public QStyledItemDelegate {
 public:
-    DesktopItemView(const QString &file, QWidget *parent) : QWidget(parent)
-    , m_current(false)
-    {
-        m_path = file;
-
-        QVBoxLayout *layout = new QVBoxLayout(this);
-        layout->setSpacing(5);
-        layout->setContentsMargins(10, 10, 10, 10);
-        QLabel *iconLabel = new QLabel(this);
-        iconLabel->setFixedSize(50, 50);
-        iconLabel->setScaledContents(true);
-        iconLabel->setAlignment(Qt::AlignCenter);
-        iconLabel->setPixmap(provider.icon(QFileInfo(file)).pixmap(70, 70));
-        layout->addWidget(iconLabel, 0, Qt::AlignCenter);
-
-        QLabel *titleLabel = new QLabel(this);
-        titleLabel->setFixedSize(80, 25);
-        titleLabel->setAlignment(Qt::AlignCenter);
-        QFont font = titleLabel->font();
-        font.setBold(true);
-        titleLabel->setFont(font);
-        const QString fileName = QFileInfo(m_path).fileName();
-        QString txt = titleLabel->fontMetrics().elidedText(fileName, Qt::ElideRight, titleLabel->width());
-        if(txt != fileName) setToolTip(fileName);
-        titleLabel->setText(txt);
-        layout->addWidget(titleLabel);
-
-        setFixedSize(100, 100);
-        setMouseTracking(true);
-
-        currentChanged(false, false);
-    }
-
-    void open() {
-        QProcess::startDetached("xdg-open", {m_path});
-    }
+    using QStyledItemDelegate::QStyledItemDelegate;
 
-    void currentChanged(bool current, bool hover=false) {
-        m_current = current;
-        setStyleSheet(QString("QLabel {color: %1} DesktopItemView { background-color: %2; border-radius: 10px; }")
-                    .arg(m_current ? palette().highlight().color().name() : palette().windowText().color().name())
-                    .arg(color(current, hover)));
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override {
+        Q_UNUSED(option)
+        Q_UNUSED(index)
+        return QSize(100, 100);
     }
 
-
-protected:
-    void enterEvent(QEvent *event) override {
-        if(!m_current)
-            currentChanged(m_current, true);
-        QWidget::enterEvent(event);
-    }
-
-    void leaveEvent(QEvent *event) override {
-        if(!m_current)
-            currentChanged(m_current, false);
-        QWidget::leaveEvent(event);
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override {
+        const bool current = option.state & QStyle::State_Selected;
+        const bool hover = option.state & QStyle::State_MouseOver;
+        const int background = DGuiApplicationHelper::instance()->themeType() == DGuiApplicationHelper::LightType ? 0 : 255;
+
+        painter->save();
+        painter->setRenderHint(QPainter::Antialiasing);
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(QColor(background, background, background, 255 * (current ? .4 : (hover ? .3 : .2))));
+        painter->drawRoundedRect(option.rect, 10, 10);
+
+        const QRect iconRect(option.rect.x() + (option.rect.width() - 50) / 2, option.rect.y() + 10, 50, 50);
+        index.data(Qt::DecorationRole).value<QIcon>().paint(painter, iconRect);
+
+        const QFont font = titleFont(option);
+        const QRect titleRect(option.rect.x() + (option.rect.width() - 80) / 2, iconRect.bottom() + 6, 80, 25);
+        painter->setFont(font);
+        painter->setPen(current ? option.palette.highlight().color() : option.palette.windowText().color());
+        painter->drawText(titleRect, Qt::AlignCenter, QFontMetrics(font).elidedText(index.data().toString(), Qt::ElideRight, titleRect.width()));
+        painter->restore();
     }
 
-    void paintEvent(QPaintEvent *event) override
-    {
-        Q_UNUSED(event)
-        QStyleOption opt;
-        opt.init(this);
-        QPainter p(this);
-        style()->drawPrimitive(QStyle::PE_Widget, &opt, &p, this);
+    bool helpEvent(QHelpEvent *event, QAbstractItemView *view, const QStyleOptionViewItem &option, const QModelIndex &index) override {
+        // 文件名完整显示时不需要提示
+        if (event->type() == QEvent::ToolTip) {
+            const QString fileName = index.data().toString();
+            if (QFontMetrics(titleFont(option)).elidedText(fileName, Qt::ElideRight, 80) == fileName) {
+                QToolTip::hideText();
+                return true;
+            }
+        }
+        return QStyledItemDelegate::helpEvent(event, view, option, index);
     }
 
 private:
-    QString color(bool on, bool hover) {
-        if(DGuiApplicationHelper::instance()->themeType() == DGuiApplicationHelper::LightType)
-            return QString("rgba(0, 0, 0, %1)").arg(on ? "40%" : (hover ? "30%" : "20%"));
-        else
-            return QString("rgba(255,255,255, %1)").arg(on ? "40%" : (hover ? "30%" : "20%"));
+    static QFont titleFont(const QStyleOptionViewItem &option) {
+        QFont font = option.font;
+        font.setBold(true);
+        return font;
     }
-
-private:
-    QString m_path;
-    bool m_current;
-
-    friend class FolderWidget;
 };
 
-class FolderWidget : public QListWidget {
+class FolderWidget : public QListView {
     Q_OBJECT
 public:
-    FolderWidget(QString path) : QListWidget()
+    FolderWidget(QString path) : QListView()
     , m_path(path)
     , m_mouseLeaveTimer(new QTimer(this))
+    , m_refreshTimer(new QTimer(this))
     , m_watcher(new QFileSystemWatcher({path}, this))
+    , m_model(new FolderModel(path, this))
+    , m_scanWatcher(new QFutureWatcher<QVector<FolderEntry>>(this))
+    , m_dirty(false)
     {
-        setFlow(QListWidget::LeftToRight);
-        setViewMode(QListWidget::IconMode);
+        setFlow(QListView::LeftToRight);
+        setViewMode(QListView::IconMode);
         setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
         setResizeMode(QListView::Adjust);
-        setSelectionBehavior(QListWidget::SelectItems);
-        setSelectionMode(QListWidget::SingleSelection);
+        setSelectionBehavior(QListView::SelectItems);
+        setSelectionMode(QListView::SingleSelection);
         setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
         setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-        setVerticalScrollMode(QListWidget::ScrollPerPixel);
-        setDragDropMode(QListWidget::DragDrop);
+        setVerticalScrollMode(QListView::ScrollPerPixel);
+        setDragDropMode(QListView::DragOnly);
         setUniformItemSizes(true);
         setMouseTracking(true);
+        viewport()->setAttribute(Qt::WA_Hover);
         verticalScrollBar()->setSingleStep(30);
 
         setSpacing(30);
         setContentsMargins(30, 10, 30, 10);
 
-        connect(this, &FolderWidget::itemClicked, [this](QListWidgetItem *item){
-            qobject_cast<DesktopItemView*>(itemWidget(item))->open();
-        });
+        setModel(m_model);
+        setItemDelegate(new FolderItemDelegate(this));
 
-        connect(this, &FolderWidget::currentItemChanged, this, [this](QListWidgetItem *current, QListWidgetItem *prev){
-            if(current)
-                if(DesktopItemView *v = qobject_cast<DesktopItemView*>(itemWidget(current)))
-                    v->currentChanged(true);
-            if(prev)
-                if(DesktopItemView *v = qobject_cast<DesktopItemView*>(itemWidget(prev)))
-                    v->currentChanged(false);
+        connect(this, &FolderWidget::clicked, this, [](const QModelIndex &index){
+            QProcess::startDetached("xdg-open", {index.data(FolderModel::FilePathRole).toString()});
         });
 
         connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::themeTypeChanged, this, [this]{
-            const int current = currentRow();
-            for(int i=0, len=count(); i<len; i++)
-                qobject_cast<DesktopItemView*>(itemWidget(item(i)))->currentChanged(current == i);
+            viewport()->update();
         });
 
         m_mouseLeaveTimer->setSingleShot(true);
         m_mouseLeaveTimer->setInterval(100);
 
+        // 批量增删文件时目录变化会连续触发，合并后再扫描
+        m_refreshTimer->setSingleShot(true);
+        m_refreshTimer->setInterval(200);
+
         connect(m_mouseLeaveTimer, &QTimer::timeout, this, &FolderWidget::checkMouseLeave);
-        connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &FolderWidget::refresh);
+        connect(m_refreshTimer, &QTimer::timeout, this, &FolderWidget::refresh);
+        connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, [this]{
+            m_dirty = true;
+            if(isVisible() && !m_refreshTimer->isActive())
+                m_refreshTimer->start();
+        });
+        connect(m_scanWatcher, &QFutureWatcher<QVector<FolderEntry>>::finished, this, [this]{
+            m_model->update(m_scanWatcher->result());
+            // 扫描期间目录又发生了变化
+            if(m_dirty && isVisible())
+                m_refreshTimer->start();
+        });
+
         refresh();
     }
 
     ~FolderWidget() {
-        // m_watcher->cancel();
+        m_scanWatcher->waitForFinished();
     }
 
     void refresh() {
-        clear();
-
-        QDir dir(m_path);
-
-        if(!dir.exists() || dir.isEmpty(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot)) return;
-
-        for(auto file : dir.entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot)) {
-            QListWidgetItem *item = new QListWidgetItem(this);
-            item->setSizeHint(QSize(100, 100));
-            this->addItem(item);
+        if(m_scanWatcher->isRunning())
+            return;
 
-            DesktopItemView *desktopItemView = new DesktopItemView(file.absoluteFilePath(), this);
-            this->setItemWidget(item, desktopItemView);
-        }
-    }
-
-    void clear() {
-        while(QListWidgetItem *item = takeItem(0)) {
-            itemWidget(item)->deleteLater();
-            delete item;
-        }
+        m_dirty = false;
+        m_scanWatcher->setFuture(QtConcurrent::run(FolderModel::scan, m_path, m_model->known()));
     }
 
     void prepareHide()
@@ -204,18 +176,12 @@ public:
         m_mouseLeaveTimer->start();
     }
 
-    QStringList mimeTypes() const {
-        return QStringList("text/uri-list");
-    }
-
-    QMimeData *mimeData(const QList<QListWidgetItem *> items) const {
-        QMimeData *data = new QMimeData();
-        QList<QUrl> urls;
-        for(auto item : items)
-            urls << QUrl::fromLocalFile(qobject_cast<DesktopItemView*>(itemWidget(item))->m_path);
-
-        data->setUrls(urls);
-        return data;
+    // 隐藏期间只记录目录变化，显示时再刷新
+    void showEvent(QShowEvent *e)
+    {
+        QListView::showEvent(e);
+        if(m_dirty)
+            refresh();
     }
 
 signals:
@@ -224,7 +190,11 @@ signals:
 private:
     QString m_path;
     QTimer *m_mouseLeaveTimer;
+    QTimer *m_refreshTimer;
     QFileSystemWatcher *m_watcher;
+    FolderModel *m_model;
+    QFutureWatcher<QVector<FolderEntry>> *m_scanWatcher;
+    bool m_dirty;
 };
 
 FolderItem::FolderItem(QString path, QWidget *parent) : DockItem(parent)
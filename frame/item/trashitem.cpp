@@ -10,39 +10,164 @@
 #include <QStandardPaths>
 #include <DDesktopServices>
 #include <QMessageBox>
-#include <QFileSystemWatcher>
+#include <QDirIterator>
+#include <QDebug>
+#include <QSocketNotifier>
+#include <QTimer>
 #include <QDBusInterface>
 
+#include <sys/inotify.h>
+#include <unistd.h>
+
 static const QString TRASHPATH = QStandardPaths::writableLocation(QStandardPaths::HomeLocation) + "/.local/share/Trash";
 static const QString TRASHEXPUNGED = TRASHPATH + "/expunged";
 static const QString TRASHFILE = TRASHPATH + "/files";
 static const QString TRASHINFO = TRASHPATH + "/info";
 
 TrashItem::TrashItem(QWidget *parent) : DockItem(parent)
-    , m_watcher(new QFileSystemWatcher({TRASHFILE}, this))
+    , m_inotifyFd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+    , m_watchFd(-1)
+    , m_parentWatchFd(-1)
+    , m_notifier(nullptr)
+    , m_updateTimer(new QTimer(this))
+    , m_reconcileTimer(new QTimer(this))
+    , m_count(0)
+    , m_empty(false)
 {
     setAcceptDrops(true);
-    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &TrashItem::refershIcon);
+
+    // 大量文件移入移出时事件会连续到达，合并后再更新图标
+    m_updateTimer->setSingleShot(true);
+    m_updateTimer->setInterval(100);
+    connect(m_updateTimer, &QTimer::timeout, this, &TrashItem::updateState);
+
+    // 定期用目录是否为空做一次低成本校验，不一致时才重新计数
+    m_reconcileTimer->setInterval(60 * 1000);
+    connect(m_reconcileTimer, &QTimer::timeout, this, &TrashItem::reconcile);
+    m_reconcileTimer->start();
+
+    if (m_inotifyFd != -1) {
+        m_notifier = new QSocketNotifier(m_inotifyFd, QSocketNotifier::Read, this);
+        connect(m_notifier, &QSocketNotifier::activated, this, &TrashItem::readEvents);
+    } else {
+        qWarning() << "inotify init failed, trash state only refreshed periodically";
+    }
+
+    watchTrash();
     refershIcon();
 }
 
+TrashItem::~TrashItem()
+{
+    if (m_inotifyFd != -1)
+        close(m_inotifyFd);
+}
+
 QString TrashItem::popupTips() {
     return m_count == 0 ? "垃圾桶" : QString("垃圾桶（ %1 项 ）").arg(m_count);
 }
 
+// 完整计数一次，只在启动、事件丢失或校验不一致时调用
 void TrashItem::refershIcon()
 {
     QDir dir(TRASHFILE);
-    dir.setFilter(QDir::AllEntries | QDir::NoDotAndDotDot);
-    if (dir.exists() == false or dir.isEmpty()) {
-        m_icon = QIcon::fromTheme("user-trash");
-        m_count = 0;
-    } else {
-        m_icon = QIcon::fromTheme("user-trash-full");
-        m_count = dir.count();
+    dir.setFilter(QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+    const QStringList names = dir.exists() ? dir.entryList() : QStringList();
+    m_names = QSet<QString>(names.begin(), names.end());
+    m_count = m_names.size();
+    updateState();
+}
+
+void TrashItem::watchTrash()
+{
+    if (m_inotifyFd == -1)
+        return;
+
+    // 监听 Trash 目录本身，files 目录被重建时立即重新监听，不必等待定期校验
+    if (m_parentWatchFd == -1)
+        m_parentWatchFd = inotify_add_watch(m_inotifyFd, TRASHPATH.toLocal8Bit().constData(),
+                                            IN_CREATE | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+
+    if (m_watchFd != -1)
+        inotify_rm_watch(m_inotifyFd, m_watchFd);
+
+    m_watchFd = inotify_add_watch(m_inotifyFd, TRASHFILE.toLocal8Bit().constData(),
+                                  IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+}
+
+/**
+ * @brief TrashItem::readEvents 根据增删事件直接调整计数，代价只与事件数量有关
+ */
+void TrashItem::readEvents()
+{
+    alignas(struct inotify_event) char buffer[4096];
+    bool rescan = false;
+
+    ssize_t length;
+    while ((length = read(m_inotifyFd, buffer, sizeof(buffer))) > 0) {
+        for (char *p = buffer; p < buffer + length;) {
+            const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(p);
+            p += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                rescan = true;
+            } else if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                // 清空回收站时 files 目录会被删除重建，需要重新监听
+                if (event->wd == m_watchFd) {
+                    m_watchFd = -1;
+                    rescan = true;
+                } else if (event->wd == m_parentWatchFd) {
+                    m_parentWatchFd = -1;
+                }
+            } else if (event->wd == m_parentWatchFd) {
+                if (event->len && qstrcmp(event->name, "files") == 0)
+                    rescan = true;
+            } else if (event->wd == m_watchFd && event->len) {
+                const QString name = QString::fromLocal8Bit(event->name);
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    // 移动覆盖同名文件时条目数不变，重新计数而不是累加
+                    if (m_names.contains(name))
+                        rescan = true;
+                    else
+                        m_names.insert(name);
+                } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    m_names.remove(name);
+                }
+            }
+        }
+    }
+
+    m_count = m_names.size();
+
+    if (rescan) {
+        watchTrash();
+        refershIcon();
+    } else if (!m_updateTimer->isActive()) {
+        m_updateTimer->start();
     }
 }
 
+void TrashItem::updateState()
+{
+    const bool empty = m_count == 0;
+    if (!m_icon.isNull() && empty == m_empty)
+        return;
+
+    m_empty = empty;
+    m_icon = QIcon::fromTheme(empty ? "user-trash" : "user-trash-full");
+    update();
+}
+
+void TrashItem::reconcile()
+{
+    if (m_watchFd == -1 || m_parentWatchFd == -1)
+        watchTrash();
+
+    QDirIterator it(TRASHFILE, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+    if (it.hasNext() == (m_count == 0) || m_inotifyFd == -1)
+        refershIcon();
+}
+
 void TrashItem::mousePressEvent(QMouseEvent *e)
 {
     if (e->button() == Qt::LeftButton)
@@ -98,14 +223,13 @@ void TrashItem::invokedMenuItem(const QString &itemId, const bool checked)
     {
         if (QMessageBox::Ok == QMessageBox::warning(this, "警告", "清空后数据将不可恢复！\n确认清空回收站？", QMessageBox::Cancel | QMessageBox::Ok, QMessageBox::Ok))
         {
-            m_watcher->blockSignals(true);
             QProcess::execute("rm", {"-r", TRASHFILE, TRASHINFO});
             QDir dir(TRASHPATH);
             dir.mkdir("files");
             dir.mkdir("info");
             Dtk::Widget::DDesktopServices::playSystemSoundEffect(Dtk::Widget::DDesktopServices::SSE_EmptyTrash);
+            watchTrash();
             refershIcon();
-            m_watcher->blockSignals(false);
         }
     }
 }
@@ -3,12 +3,16 @@
 
 #include "dockitem.h"
 
+#include <QSet>
+
+class QSocketNotifier;
 class TrashItem : public DockItem
 {
     Q_OBJECT
 
 public:
     explicit TrashItem(QWidget *parent = nullptr);
+    ~TrashItem();
 
     inline ItemType itemType() const override {return Plugins;}
     void refershIcon();
@@ -24,8 +28,21 @@ protected:
     const QString contextMenu() const Q_DECL_OVERRIDE;
 
 private:
-    QFileSystemWatcher *m_watcher;
+    void watchTrash();
+    void readEvents();
+    void updateState();
+    void reconcile();
+
+private:
+    int m_inotifyFd;
+    int m_watchFd;
+    int m_parentWatchFd;
+    QSocketNotifier *m_notifier;
+    QTimer *m_updateTimer;
+    QTimer *m_reconcileTimer;
+    QSet<QString> m_names;
     int m_count;
+    bool m_empty;
 };
 
 #endif // TRASHITEM_H
\ No newline at end of file
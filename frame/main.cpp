@@ -23,6 +23,7 @@
 #include "window/dockitemmanager.h"
 #include "dbus/dbusdockadaptors.h"
 #include "dbus/dockdaemonadaptors.h"
+#include "util/animationclock.h"
 #include <QDir>
 #include <DApplication>
 #include <DLog>
@@ -90,6 +91,9 @@ int main(int argc, char *argv[])
     QDir::setCurrent(QApplication::applicationDirPath());
 #endif
 
+    // 所有动画由同一个帧时钟驱动
+    AnimationClock::instance()->install();
+
     MainWindow mw;
     DBusDockAdaptors adaptor(&mw);
     DockDaemonDBusAdaptor dockDaemonAdaptor(&mw);
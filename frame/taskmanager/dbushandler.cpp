@@ -7,6 +7,10 @@
 #include "common.h"
 #include "entry.h"
 #include "windowinfok.h"
+#include "../util/perfstatistics.h"
+
+#include <QDBusPendingCallWatcher>
+#include <QElapsedTimer>
 
 DBusHandler::DBusHandler(TaskManager *taskmanager, QObject *parent)
     : QObject(parent)
@@ -52,25 +56,73 @@ QString DBusHandler::getCurrentWM()
     return m_wmSwitcher->CurrentWM().value();
 }
 
+/**
+ * @brief DBusHandler::asyncCall 异步调用，结果在界面线程通过 callback 返回，服务无响应时 timeout 毫秒后返回错误
+ */
+void DBusHandler::asyncCall(const QString &service, const QString &path, const QString &interface, const char *method,
+                            const QVariantList &args, const std::function<void(const QDBusMessage &)> &callback, int timeout)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(service, path, interface, QString::fromLatin1(method));
+    message.setArguments(args);
+
+#ifdef ENABLE_PERF_TIMERS
+    QElapsedTimer timer;
+    timer.start();
+#endif
+
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(message, timeout), this);
+#ifdef ENABLE_PERF_TIMERS
+    // 先于 callback 连接，记录的耗时不包括 callback 本身
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [method, timer] {
+        PerfStatistics::instance()->record("dbus", method, timer.nsecsElapsed());
+    });
+#endif
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [method, callback](QDBusPendingCallWatcher *call) {
+        const QDBusMessage reply = call->reply();
+        if (reply.type() == QDBusMessage::ErrorMessage)
+            qWarning() << method << "failed:" << reply.errorName() << reply.errorMessage();
+
+        if (callback)
+            callback(reply);
+
+        call->deleteLater();
+    });
+}
+
+/**
+ * @brief DBusHandler::blockingCall 需要立即得到结果的调用，只在 timeout 毫秒内等待
+ */
+QDBusMessage DBusHandler::blockingCall(const QString &service, const QString &path, const QString &interface, const char *method,
+                                       const QVariantList &args, int timeout)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(service, path, interface, QString::fromLatin1(method));
+    message.setArguments(args);
+
+    QElapsedTimer timer;
+    timer.start();
+    const QDBusMessage reply = QDBusConnection::sessionBus().call(message, QDBus::Block, timeout);
+#ifdef ENABLE_PERF_TIMERS
+    PerfStatistics::instance()->record("dbus", method, timer.nsecsElapsed());
+#endif
+    return reply;
+}
+
 void DBusHandler::launchApp(QString desktopFile, uint32_t timestamp, QStringList files)
 {
-    QDBusInterface *interface = new QDBusInterface("org.deepin.dde.Application1.Manager", "/org/deepin/dde/Application1/Manager", "org.deepin.dde.Application1.Manager");
-    interface->call("LaunchApp", desktopFile, timestamp, files);
-    interface->deleteLater();
+    asyncCall("org.deepin.dde.Application1.Manager", "/org/deepin/dde/Application1/Manager", "org.deepin.dde.Application1.Manager",
+              "LaunchApp", { desktopFile, timestamp, files });
 }
 
 void DBusHandler::launchAppAction(QString desktopFile, QString action, uint32_t timestamp)
 {
-    QDBusInterface *interface = new QDBusInterface("org.deepin.dde.Application1.Manager", "/org/deepin/dde/Application1/Manager", "org.deepin.dde.Application1.Manager");
-    interface->call("LaunchAppAction", desktopFile, action, timestamp);
-    interface->deleteLater();
+    asyncCall("org.deepin.dde.Application1.Manager", "/org/deepin/dde/Application1/Manager", "org.deepin.dde.Application1.Manager",
+              "LaunchAppAction", { desktopFile, action, timestamp });
 }
 
 void DBusHandler::markAppLaunched(const QString &filePath)
 {
-    QDBusInterface *interface = new QDBusInterface("org.deepin.dde.AlRecorder1", "/org/deepin/dde/AlRecorder1", "org.deepin.dde.AlRecorder1");
-    interface->call("MarkLaunched", filePath);
-    interface->deleteLater();
+    asyncCall("org.deepin.dde.AlRecorder1", "/org/deepin/dde/AlRecorder1", "org.deepin.dde.AlRecorder1",
+              "MarkLaunched", { filePath });
 }
 
 bool DBusHandler::wlShowingDesktop()
@@ -133,35 +185,43 @@ void DBusHandler::listenKWindowSignals(WindowInfoK *windowInfo)
     if (!window)
         return;
 
+    // 变化信号只触发对应属性的异步刷新，缓存值改变后再通知界面
     connect(window, &PlasmaWindow::TitleChanged, this, [=] {
-        windowInfo->updateTitle();
-        auto entry = m_taskmanager->getEntryByWindowId(windowInfo->getXid());
-        if (entry && entry->getCurrentWindowInfo() == windowInfo)
-            entry->updateName();
+        windowInfo->updateTitle([=] {
+            auto entry = m_taskmanager->getEntryByWindowId(windowInfo->getXid());
+            if (entry && entry->getCurrentWindowInfo() == windowInfo)
+                entry->updateName();
+        });
     });
     connect(window, &PlasmaWindow::IconChanged, this, [=] {
-        windowInfo->updateIcon();
-        auto entry = m_taskmanager->getEntryByWindowId(windowInfo->getXid());
-        if (!entry) return;
+        windowInfo->updateIcon([=] {
+            auto entry = m_taskmanager->getEntryByWindowId(windowInfo->getXid());
+            if (!entry) return;
 
-        entry->updateIcon();
+            entry->updateIcon();
+        });
     });
 
     // DemandingAttention changed
     connect(window, &PlasmaWindow::DemandsAttentionChanged, this, [=] {
-        windowInfo->updateDemandingAttention();
-        auto entry = m_taskmanager->getEntryByWindowId(windowInfo->getXid());
-        if (!entry) return;
+        windowInfo->updateDemandingAttention([=] {
+            auto entry = m_taskmanager->getEntryByWindowId(windowInfo->getXid());
+            if (!entry) return;
 
-        entry->updateExportWindowInfos();
+            entry->updateExportWindowInfos();
+        });
     });
 
     // Geometry changed
     connect(window, &PlasmaWindow::GeometryChanged, this, [=] {
-        if (!windowInfo->updateGeometry()) return;
-
-        m_taskmanager->handleWindowGeometryChanged();
+        windowInfo->updateGeometry([=] {
+            m_taskmanager->handleWindowGeometryChanged();
+        });
     });
+
+    connect(window, &PlasmaWindow::SkipTaskbarChanged, this, [=] { windowInfo->updateSkipTaskbar(); });
+    connect(window, &PlasmaWindow::MinimizeableChanged, this, [=] { windowInfo->updateMinimizeable(); });
+    connect(window, &PlasmaWindow::MinimizedChanged, this, [=] { windowInfo->updateMinimized(); });
 }
 
 PlasmaWindow *DBusHandler::createPlasmaWindow(QString objPath)
@@ -196,17 +256,15 @@ void DBusHandler::cancelPreviewWindow()
 // TODO: 待优化点， 查看Bamf根据windowId获取对应应用desktopFile路径实现方式, 移除bamf依赖
 QString DBusHandler::getDesktopFromWindowByBamf(XWindow windowId)
 {
-    QDBusInterface *interface0 = new QDBusInterface("org.ayatana.bamf", "/org/ayatana/bamf/matcher", "org.ayatana.bamf.matcher");
-    QDBusReply<QString> replyApplication = interface0->call("ApplicationForXid", windowId);
+    // 识别窗口需要同步得到结果，bamf 没有响应时最多等待 500 毫秒
+    QDBusReply<QString> replyApplication = blockingCall("org.ayatana.bamf", "/org/ayatana/bamf/matcher", "org.ayatana.bamf.matcher",
+                                                        "ApplicationForXid", { uint(windowId) }, 500);
     QString appObjPath = replyApplication.value();
-    interface0->deleteLater();
     if (!replyApplication.isValid() || appObjPath.isEmpty())
         return "";
 
-
-    QDBusInterface *interface = new QDBusInterface("org.ayatana.bamf", appObjPath, "org.ayatana.bamf.application");
-    QDBusReply<QString> replyDesktopFile = interface->call("DesktopFile");
-    interface->deleteLater();
+    QDBusReply<QString> replyDesktopFile = blockingCall("org.ayatana.bamf", appObjPath, "org.ayatana.bamf.application",
+                                                        "DesktopFile", {}, 500);
     if (replyDesktopFile.isValid())
         return replyDesktopFile.value();
 
@@ -17,6 +17,8 @@
 #include <QDBusConnection>
 #include <QDBusMessage>
 
+#include <functional>
+
 class TaskManager;
 
 // 处理DBus交互
@@ -58,6 +60,13 @@ public:
     // XWindow -> desktopFile
     QString getDesktopFromWindowByBamf(XWindow windowId);
 
+protected:
+    // 不经过 QDBusInterface 的内省，直接发送方法调用，method 同时作为耗时统计的名字
+    void asyncCall(const QString &service, const QString &path, const QString &interface, const char *method,
+                   const QVariantList &args, const std::function<void(const QDBusMessage &)> &callback = nullptr, int timeout = 5000);
+    QDBusMessage blockingCall(const QString &service, const QString &path, const QString &interface, const char *method,
+                              const QVariantList &args, int timeout);
+
 private Q_SLOTS:
     void handleWlActiveWindowChange();
     void onActiveWindowButtonRelease(int type, int x, int y, const QString &key);
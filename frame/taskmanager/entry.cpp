@@ -141,7 +141,7 @@ void Entry::setAppInfo(AppInfo *appinfo)
     setPropDesktopFile(appinfo ? appinfo->getFileName(): "");
     if (!m_winIconPreferred) {
         QString id = m_appInfo->getId();
-        auto perferredApps = m_taskmanager->getWinIconPreferredApps();
+        const auto &perferredApps = m_taskmanager->getWinIconPreferredApps();
         if (perferredApps.contains(id)|| appinfo->getIcon().size() == 0) {
             m_winIconPreferred = true;
             return;
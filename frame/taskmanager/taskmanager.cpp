@@ -22,6 +22,7 @@
 #include <QMap>
 #include <QTimer>
 #include <QList>
+#include <QCoreApplication>
 
 #include <cstdint>
 #include <iterator>
@@ -52,6 +53,12 @@ TaskManager::TaskManager(QObject *parent)
  , m_dbusHandler(new DBusHandler(this))
  , m_activeWindow(nullptr)
  , m_activeWindowOld(nullptr)
+ , m_persistTimer(new QTimer(this))
+ , m_dockedAppsDirty(false)
+ , m_recentAppsDirty(false)
+ , m_persistRequests(0)
+ , m_persistWrites(0)
+ , m_persistSuppressed(0)
 {
     qRegisterMetaType<WindowInfoMap>("WindowInfoMap");
     qRegisterMetaType<uint32_t>("uint32_t");
@@ -66,6 +73,12 @@ TaskManager::TaskManager(QObject *parent)
         qFatal("Unknown XDG_SESSION_TYPE '%s'", sessionType().constData());
     }
 
+    // 短时间内多次保存应用列表时只写入一次，退出前写入剩余的修改
+    m_persistTimer->setSingleShot(true);
+    m_persistTimer->setInterval(500);
+    connect(m_persistTimer, &QTimer::timeout, this, &TaskManager::flushAppLists);
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &TaskManager::flushAppLists);
+
     initSettings();
     initEntries();
 
@@ -1024,6 +1037,8 @@ void TaskManager::attachWindow(WindowInfoBase *info)
  */
 void TaskManager::detachWindow(WindowInfoBase *info)
 {
+    Q_EMIT windowDetached(info->getXid());
+
     Entry *entry = m_entries->getByWindowId(info->getXid());
     if (!entry)
         return;
@@ -1112,13 +1127,7 @@ void TaskManager::handleActiveWindowChanged(WindowInfoBase *info)
  */
 void TaskManager::saveDockedApps()
 {
-    QStringList dockedApps;
-    for (auto entry : m_entries->filterDockedEntries()) {
-        QString path = entry->getAppInfo()->getFileName();
-        dockedApps << path;
-    }
-
-    SETTING->setDockedApps(dockedApps);
+    m_dockedAppsDirty = true;
 
     // 在驻留任务栏的时候，同时更新最近打开应用的信息
     updateRecentApps();
@@ -1126,16 +1135,65 @@ void TaskManager::saveDockedApps()
 
 void TaskManager::updateRecentApps()
 {
-    QStringList unDockedApps;
-    QList<Entry *> recentEntrys = m_entries->unDockedEntries();
-    for (Entry *entry : recentEntrys) {
-        if (shouldShowEntry(entry)) {
-            unDockedApps << entry->getAppInfo()->getFileName();
+    m_recentAppsDirty = true;
+    ++m_persistRequests;
+
+    if (!m_persistTimer->isActive())
+        m_persistTimer->start();
+}
+
+/**
+ * @brief TaskManager::flushAppLists 计算驻留和最近打开应用列表，只在和已保存的内容不同时写入配置
+ */
+void TaskManager::flushAppLists()
+{
+    m_persistTimer->stop();
+
+    if (m_dockedAppsDirty) {
+        m_dockedAppsDirty = false;
+
+        QStringList dockedApps;
+        for (auto entry : m_entries->filterDockedEntries()) {
+            QString path = entry->getAppInfo()->getFileName();
+            dockedApps << path;
+        }
+
+        if (dockedApps == SETTING->getDockedApps()) {
+            ++m_persistSuppressed;
+        } else {
+            SETTING->setDockedApps(dockedApps);
+            ++m_persistWrites;
         }
     }
 
-    // 保存未驻留的应用作为最近打开的应用
-    SETTING->setRecentApps(unDockedApps);
+    if (m_recentAppsDirty) {
+        m_recentAppsDirty = false;
+
+        QStringList unDockedApps;
+        QList<Entry *> recentEntrys = m_entries->unDockedEntries();
+        for (Entry *entry : recentEntrys) {
+            if (shouldShowEntry(entry)) {
+                unDockedApps << entry->getAppInfo()->getFileName();
+            }
+        }
+
+        // 保存未驻留的应用作为最近打开的应用
+        if (unDockedApps == SETTING->getRecentApps()) {
+            ++m_persistSuppressed;
+        } else {
+            SETTING->setRecentApps(unDockedApps);
+            ++m_persistWrites;
+        }
+    }
+}
+
+QVariantMap TaskManager::persistStatistics() const
+{
+    QVariantMap statistics;
+    statistics.insert("requests", m_persistRequests);
+    statistics.insert("writes", m_persistWrites);
+    statistics.insert("suppressed", m_persistSuppressed);
+    return statistics;
 }
 
 void TaskManager::removeEntryFromDock(Entry *entry)
@@ -1291,7 +1349,7 @@ ForceQuitAppMode TaskManager::getForceQuitAppStatus()
  * @brief TaskManager::getWinIconPreferredApps 获取推荐的应用窗口图标
  * @return
  */
-QVector<QString> TaskManager::getWinIconPreferredApps()
+const QVector<QString> &TaskManager::getWinIconPreferredApps()
 {
     return SETTING->getWinIconPreferredApps();
 }
@@ -1343,6 +1401,9 @@ QRect TaskManager::getFrontendWindowRect()
  */
 QStringList TaskManager::getDockedApps()
 {
+    if (m_dockedAppsDirty)
+        flushAppLists();
+
     return SETTING->getDockedApps();
 }
 
@@ -13,6 +13,7 @@
 #include <QTimer>
 #include <QMutex>
 #include <QObject>
+#include <QVariantMap>
 
 class WindowIdentify;
 class DBusHandler;
@@ -53,6 +54,8 @@ public:
     bool isWaylandEnv();
     WindowInfoK *handleActiveWindowChangedK(uint activeWin);
     void saveDockedApps();
+    void flushAppLists();
+    QVariantMap persistStatistics() const;
     void removeAppEntry(Entry *entry);
     void handleWindowGeometryChanged();
     Entry *getEntryByWindowId(XWindow windowId);
@@ -66,7 +69,7 @@ public:
     void markAppLaunched(AppInfo *appInfo);
 
     ForceQuitAppMode getForceQuitAppStatus();
-    QVector<QString> getWinIconPreferredApps();
+    const QVector<QString> &getWinIconPreferredApps();
     void handleLauncherItemDeleted(QString itemPath);
     void handleLauncherItemUpdated(QString itemPath);
 
@@ -127,6 +130,7 @@ Q_SIGNALS:
     void frontendWindowRectChanged(const QRect &dockRect);
     void showRecentChanged(bool);
     void showMultiWindowChanged(bool);
+    void windowDetached(uint xid);
 
 public Q_SLOTS:
     void updateHideState(bool delay);
@@ -179,6 +183,13 @@ private:
     WindowInfoBase *m_activeWindowOld;// 记录前一个活跃窗口信息
 
     QList<XWindow> m_clientList; // 所有窗口
+
+    QTimer *m_persistTimer;       // 合并驻留和最近应用列表的写入
+    bool m_dockedAppsDirty;
+    bool m_recentAppsDirty;
+    quint64 m_persistRequests;    // 请求保存的次数
+    quint64 m_persistWrites;      // 实际写入配置的次数
+    quint64 m_persistSuppressed;  // 列表未变化而跳过的次数
 };
 
 #endif // TASKMANAGER_H
@@ -12,7 +12,6 @@
 WaylandManager::WaylandManager(TaskManager *_taskmanager, QObject *parent)
  : QObject(parent)
  , m_taskmanager(_taskmanager)
- , m_mutex(new QMutex(QMutex::NonRecursive))
 {
 
 }
@@ -25,7 +24,7 @@ WaylandManager::WaylandManager(TaskManager *_taskmanager, QObject *parent)
 void WaylandManager::registerWindow(const QString &objPath)
 {
     qInfo() << "registerWindow: " << objPath;
-    if (findWindowByObjPath(objPath))
+    if (findWindowByObjPath(objPath) || m_pendingWindows.contains(objPath))
         return;
 
     PlasmaWindow *plasmaWindow = m_taskmanager->createPlasmaWindow(objPath);
@@ -34,37 +33,67 @@ void WaylandManager::registerWindow(const QString &objPath)
         return;
     }
 
-    if (!plasmaWindow->IsValid() || !plasmaWindow->isValid()) {
+    if (!plasmaWindow->isValid()) {
         qWarning() << "PlasmaWindow is not valid:" << objPath;
         plasmaWindow->deleteLater();
         return;
     }
 
-    QString appId = plasmaWindow->AppId();
+    fetchWindow(objPath, plasmaWindow);
+}
+
+/**
+ * @brief WaylandManager::fetchWindow 属性全部异步返回后再注册，会话恢复时大量窗口同时打开也不会阻塞界面
+ */
+void WaylandManager::fetchWindow(const QString &objPath, PlasmaWindow *plasmaWindow)
+{
+    WindowInfoK *winInfo = new WindowInfoK(plasmaWindow);
+    m_pendingWindows.insert(objPath, winInfo);
+    winInfo->fetchProperties([this, objPath, winInfo] {
+        onWindowPropertiesFetched(objPath, winInfo);
+    });
+}
+
+void WaylandManager::onWindowPropertiesFetched(const QString &objPath, WindowInfoK *winInfo)
+{
+    if (m_pendingWindows.value(objPath) != winInfo)
+        return;
+
+    m_pendingWindows.remove(objPath);
+
+    if (!winInfo->isValid()) {
+        qWarning() << "PlasmaWindow is not valid:" << objPath;
+        winInfo->deleteLater();
+        return;
+    }
+
+    QString appId = winInfo->getAppId();
     QStringList list {"dde-dock", "dde-launcher", "dde-clipboard", "dde-osd", "dde-polkit-agent", "dde-simple-egl", "dmcs", "dde-lock"};
     if (list.indexOf(appId) >= 0 || appId.startsWith("No such object path")) {
-        plasmaWindow->deleteLater();
+        winInfo->deleteLater();
         return;
     }
 
     XWindow winId = XCB->allocId();     // XCB中未发现释放XID接口
-    XWindow realId = plasmaWindow->WindowId();
+    XWindow realId = winInfo->getWindowId();
     if (realId)
         winId = realId;
 
-    WindowInfoK *winInfo = new WindowInfoK(plasmaWindow, winId);
+    winInfo->changeXid(winId);
     m_taskmanager->listenKWindowSignals(winInfo);
     insertWindow(objPath, winInfo);
     m_taskmanager->attachOrDetachWindow(winInfo);
-    if (winId) {
-        m_windowInfoMap[winId] = winInfo;
-    }
 }
 
 // 取消注册窗口
 void WaylandManager::unRegisterWindow(const QString &objPath)
 {
     qInfo() << "unRegisterWindow: " << objPath;
+    if (m_pendingWindows.contains(objPath)) {
+        m_pendingWindows.take(objPath)->deleteLater();
+        return;
+    }
+
     WindowInfoK *winInfo = findWindowByObjPath(objPath);
     if (!winInfo)
         return;
@@ -74,46 +103,41 @@ void WaylandManager::unRegisterWindow(const QString &objPath)
     deleteWindow(objPath);
 }
 
-WindowInfoK *WaylandManager::findWindowById(uint activeWin)
+WindowInfoK *WaylandManager::findWindowById(uint activeWin) const
 {
-    QMutexLocker locker(m_mutex);
-    for (auto iter = m_kWinInfos.begin(); iter != m_kWinInfos.end(); iter++) {
-        if (iter.value()->getInnerId() == QString::number(activeWin)) {
-            return iter.value();
-        }
-    }
-
-    return nullptr;
+    return m_idIndex.value(activeWin, nullptr);
 }
 
-WindowInfoK *WaylandManager::findWindowByXid(XWindow xid)
+WindowInfoK *WaylandManager::findWindowByXid(XWindow xid) const
 {
-    WindowInfoK *winInfo = nullptr;
-    for (auto iter = m_kWinInfos.begin(); iter != m_kWinInfos.end(); iter++) {
-        if (iter.value()->getXid() == xid) {
-            winInfo = iter.value();
-            break;
-        }
-    }
-
-    return winInfo;
+    return m_windowInfoMap.value(xid, nullptr);
 }
 
-WindowInfoK *WaylandManager::findWindowByObjPath(QString objPath)
+WindowInfoK *WaylandManager::findWindowByObjPath(const QString &objPath) const
 {
-    if (m_kWinInfos.find(objPath) == m_kWinInfos.end())
-        return nullptr;
-
-    return m_kWinInfos[objPath];
+    return m_kWinInfos.value(objPath, nullptr);
 }
 
-void WaylandManager::insertWindow(QString objPath, WindowInfoK *windowInfo)
+/**
+ * @brief WaylandManager::insertWindow 注册窗口时 internalId 和 xid 已经确定，同时写入三个索引
+ */
+void WaylandManager::insertWindow(const QString &objPath, WindowInfoK *windowInfo)
 {
-    QMutexLocker locker(m_mutex);
     m_kWinInfos[objPath] = windowInfo;
+    m_idIndex[windowInfo->getInternalId()] = windowInfo;
+    if (windowInfo->getXid())
+        m_windowInfoMap[windowInfo->getXid()] = windowInfo;
 }
 
-void WaylandManager::deleteWindow(QString objPath)
+void WaylandManager::deleteWindow(const QString &objPath)
 {
-    m_kWinInfos.remove(objPath);
+    WindowInfoK *windowInfo = m_kWinInfos.take(objPath);
+    if (!windowInfo)
+        return;
+
+    // 只删除仍然指向该窗口的索引，避免误删复用同一 id 的新窗口
+    if (m_idIndex.value(windowInfo->getInternalId()) == windowInfo)
+        m_idIndex.remove(windowInfo->getInternalId());
+    if (m_windowInfoMap.value(windowInfo->getXid()) == windowInfo)
+        m_windowInfoMap.remove(windowInfo->getXid());
 }
@@ -10,7 +10,7 @@
 
 #include <QObject>
 #include <QMap>
-#include <QMutex>
+#include <QHash>
 
 class TaskManager;
 
@@ -24,17 +24,26 @@ public:
     void registerWindow(const QString &objPath);
     void unRegisterWindow(const QString &objPath);
 
-    WindowInfoK *findWindowById(uint activeWin);
-    WindowInfoK *findWindowByXid(XWindow xid);
-    WindowInfoK *findWindowByObjPath(QString objPath);
-    void insertWindow(QString objPath, WindowInfoK *windowInfo);
-    void deleteWindow(QString objPath);
+    WindowInfoK *findWindowById(uint activeWin) const;
+    WindowInfoK *findWindowByXid(XWindow xid) const;
+    WindowInfoK *findWindowByObjPath(const QString &objPath) const;
+    void insertWindow(const QString &objPath, WindowInfoK *windowInfo);
+    void deleteWindow(const QString &objPath);
+
+protected:
+    void fetchWindow(const QString &objPath, PlasmaWindow *plasmaWindow);
+    const QMap<QString, WindowInfoK *> &pendingWindows() const { return m_pendingWindows; }
+
+private:
+    void onWindowPropertiesFetched(const QString &objPath, WindowInfoK *winInfo);
 
 private:
     TaskManager *m_taskmanager;
-    QMap<QString, WindowInfoK *> m_kWinInfos;       // dbusObjectPath -> kwayland window Info
-    QMap<XWindow, WindowInfoK *> m_windowInfoMap;
-    QMutex *m_mutex;
+    // 只在界面线程访问，三个索引在 insertWindow/deleteWindow 中同步维护
+    QHash<QString, WindowInfoK *> m_kWinInfos;      // dbusObjectPath -> kwayland window Info
+    QHash<uint32_t, WindowInfoK *> m_idIndex;       // internalId -> kwayland window Info
+    QHash<XWindow, WindowInfoK *> m_windowInfoMap;  // xid -> kwayland window Info
+    QMap<QString, WindowInfoK *> m_pendingWindows;  // 正在获取属性、尚未注册的窗口
 };
 
 #endif // WAYLANDMANAGER_H
@@ -9,6 +9,7 @@
 
 #include <chrono>
 #include <qobject.h>
+#include <QDBusPendingCallWatcher>
 
 WindowInfoK::WindowInfoK(PlasmaWindow *window, XWindow _xid, QObject *parent)
  : WindowInfoBase (parent)
@@ -17,6 +18,13 @@ WindowInfoK::WindowInfoK(PlasmaWindow *window, XWindow _xid, QObject *parent)
  , m_demaningAttention(false)
  , m_closeable(true)
  , m_plasmaWindow(window)
+ , m_valid(false)
+ , m_windowId(0)
+ , m_pid(0)
+ , m_skipTaskbar(false)
+ , m_minimizeable(true)
+ , m_minimized(false)
+ , m_pendingReplies(0)
 {
     xid = _xid;
     m_createdTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count(); // 获取当前时间，精确到纳秒
@@ -26,6 +34,64 @@ WindowInfoK::~WindowInfoK()
 {
 }
 
+/**
+ * @brief WindowInfoK::fetch 异步获取一个属性写入缓存，所有请求都返回后调用 fetchProperties 的 finished
+ */
+template<typename T>
+void WindowInfoK::fetch(const QDBusPendingReply<T> &reply, T &field, const std::function<void()> &changed)
+{
+    ++m_pendingReplies;
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(reply, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, &field, changed](QDBusPendingCallWatcher *call) {
+        QDBusPendingReply<T> result = *call;
+        call->deleteLater();
+
+        if (result.isError()) {
+            qWarning() << "fetch PlasmaWindow property failed:" << m_plasmaWindow->path() << result.error().message();
+        } else if (!(field == result.value())) {
+            field = result.value();
+            if (changed)
+                changed();
+        }
+
+        if (--m_pendingReplies == 0 && m_fetchFinished) {
+            std::function<void()> finished;
+            finished.swap(m_fetchFinished);
+            finished();
+        }
+    });
+}
+
+/**
+ * @brief WindowInfoK::fetchProperties 注册窗口时同时发出所有属性请求，不在界面线程上逐个等待 kwin 返回
+ * @param finished 全部返回后调用
+ */
+void WindowInfoK::fetchProperties(const std::function<void()> &finished)
+{
+    // Pid 取值失败或为 0 时也要创建进程信息，Entry 会直接使用 getProcess()
+    m_fetchFinished = [this, finished] {
+        pid = int(m_pid);
+        m_processInfo.reset(new ProcessInfo(pid));
+        finished();
+    };
+
+    fetch(m_plasmaWindow->IsValid(), m_valid);
+    fetch(m_plasmaWindow->AppId(), m_appId);
+    fetch(m_plasmaWindow->WindowId(), m_windowId);
+    fetch(m_plasmaWindow->InternalId(), m_internalId);
+    fetch(m_plasmaWindow->Icon(), icon);
+    fetch(m_plasmaWindow->Title(), title);
+    fetch(m_plasmaWindow->Geometry(), m_geometry);
+    fetch(m_plasmaWindow->IsDemandingAttention(), m_demaningAttention);
+    fetch(m_plasmaWindow->IsCloseable(), m_closeable);
+    fetch(m_plasmaWindow->SkipTaskbar(), m_skipTaskbar);
+    fetch(m_plasmaWindow->IsMinimizeable(), m_minimizeable);
+    fetch(m_plasmaWindow->IsMinimized(), m_minimized);
+    fetch(m_plasmaWindow->Pid(), m_pid);
+
+    m_updateCalled = true;
+}
+
 bool WindowInfoK::shouldSkip()
 {
     if (!m_updateCalled) {
@@ -33,12 +99,10 @@ bool WindowInfoK::shouldSkip()
         m_updateCalled = true;
     }
 
-    bool skip = m_plasmaWindow->SkipTaskbar();
+    bool skip = m_skipTaskbar;
 
     // 添加窗口能否最小化判断, 如果窗口不能最小化则隐藏任务栏图标
-    bool canMinimize = false;
-    canMinimize = m_plasmaWindow->IsMinimizeable();
-    if (!canMinimize)
+    if (!m_minimizeable)
         skip = true;
 
     if (skip) {
@@ -98,7 +162,7 @@ void WindowInfoK::minimize()
 
 bool WindowInfoK::isMinimized()
 {
-    return m_plasmaWindow->IsMinimized();
+    return m_minimized;
 }
 
 bool WindowInfoK::changeXid(XWindow _xid)
@@ -112,29 +176,39 @@ PlasmaWindow *WindowInfoK::getPlasmaWindow()
     return m_plasmaWindow.data();
 }
 
-bool WindowInfoK::updateGeometry()
+void WindowInfoK::updateGeometry(const std::function<void()> &changed)
 {
-    DockRect rect = m_plasmaWindow->Geometry();
-    if (m_geometry == rect)
-        return false;
+    fetch(m_plasmaWindow->Geometry(), m_geometry, changed);
+}
 
-    m_geometry = rect;
-    return true;
+void WindowInfoK::updateTitle(const std::function<void()> &changed)
+{
+    fetch(m_plasmaWindow->Title(), title, changed);
 }
 
-void WindowInfoK::updateTitle()
+void WindowInfoK::updateDemandingAttention(const std::function<void()> &changed)
 {
-    title = m_plasmaWindow->Title();
+    fetch(m_plasmaWindow->IsDemandingAttention(), m_demaningAttention, changed);
 }
 
-void WindowInfoK::updateDemandingAttention()
+void WindowInfoK::updateIcon(const std::function<void()> &changed)
 {
-    m_demaningAttention = m_plasmaWindow->IsDemandingAttention();
+    fetch(m_plasmaWindow->Icon(), icon, changed);
 }
 
-void WindowInfoK::updateIcon()
+void WindowInfoK::updateSkipTaskbar(const std::function<void()> &changed)
 {
-    icon = m_plasmaWindow->Icon();
+    fetch(m_plasmaWindow->SkipTaskbar(), m_skipTaskbar, changed);
+}
+
+void WindowInfoK::updateMinimizeable(const std::function<void()> &changed)
+{
+    fetch(m_plasmaWindow->IsMinimizeable(), m_minimizeable, changed);
+}
+
+void WindowInfoK::updateMinimized(const std::function<void()> &changed)
+{
+    fetch(m_plasmaWindow->IsMinimized(), m_minimized, changed);
 }
 
 void WindowInfoK::updateAppId()
@@ -183,14 +257,18 @@ QString WindowInfoK::getWindowType()
     return "Wayland";
 }
 
+// 同步刷新全部属性，注册时已经通过 fetchProperties 取齐，正常流程不会走到这里
 void WindowInfoK::update()
 {
     updateInternalId();
     updateAppId();
-    updateIcon();
-    updateTitle();
-    updateGeometry();
-    updateDemandingAttention();
+    icon = m_plasmaWindow->Icon();
+    title = m_plasmaWindow->Title();
+    m_geometry = m_plasmaWindow->Geometry();
+    m_demaningAttention = m_plasmaWindow->IsDemandingAttention();
+    m_skipTaskbar = m_plasmaWindow->SkipTaskbar();
+    m_minimizeable = m_plasmaWindow->IsMinimizeable();
+    m_minimized = m_plasmaWindow->IsMinimized();
     updateCloseable();
     updateProcessInfo();
 }
@@ -12,6 +12,8 @@
 #include <qobject.h>
 #include <qscopedpointer.h>
 
+#include <functional>
+
 using PlasmaWindow = org::deepin::dde::KWayland1::PlasmaWindow;
 
 class Entry;
@@ -45,16 +47,28 @@ public:
     void setAppId(QString _appId);
     bool changeXid(XWindow _xid);
     PlasmaWindow *getPlasmaWindow();
-    bool updateGeometry();
-    void updateTitle();
-    void updateDemandingAttention();
-    void updateIcon();
+    void fetchProperties(const std::function<void()> &finished);
+    bool isValid() const { return m_valid; }
+    uint32_t getInternalId() const { return m_internalId; }
+    XWindow getWindowId() const { return m_windowId; }
+    // 以下接口异步刷新缓存，值发生变化时调用 changed
+    void updateGeometry(const std::function<void()> &changed = nullptr);
+    void updateTitle(const std::function<void()> &changed = nullptr);
+    void updateDemandingAttention(const std::function<void()> &changed = nullptr);
+    void updateIcon(const std::function<void()> &changed = nullptr);
+    void updateSkipTaskbar(const std::function<void()> &changed = nullptr);
+    void updateMinimizeable(const std::function<void()> &changed = nullptr);
+    void updateMinimized(const std::function<void()> &changed = nullptr);
     void updateAppId();
     void updateInternalId();
     void updateCloseable();
     void updateProcessInfo();
     DockRect getGeometry();
 
+private:
+    template<typename T>
+    void fetch(const QDBusPendingReply<T> &reply, T &field, const std::function<void()> &changed = nullptr);
+
 private:
     bool m_updateCalled;
     QString m_appId;
@@ -63,6 +77,16 @@ private:
     bool m_closeable;
     DockRect m_geometry;
     QScopedPointer<PlasmaWindow> m_plasmaWindow;
+
+    // kwin 返回的属性缓存，注册时一次取齐，之后由变化信号更新
+    bool m_valid;
+    uint m_windowId;
+    uint m_pid;
+    bool m_skipTaskbar;
+    bool m_minimizeable;
+    bool m_minimized;
+    int m_pendingReplies;
+    std::function<void()> m_fetchFinished;
 };
 
 #endif // WINDOWINFOK_H
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "animationclock.h"
+#include "perfstatistics.h"
+
+#include <QTimer>
+#include <QGuiApplication>
+#include <QScreen>
+
+AnimationClock *AnimationClock::instance()
+{
+    static AnimationClock *clock = new AnimationClock;
+    return clock;
+}
+
+AnimationClock::AnimationClock() : QAnimationDriver()
+    , m_frameTimer(new QTimer(this))
+    , m_frameInterval(16)
+    , m_lastFrame(-1)
+    , m_frameCount(0)
+    , m_droppedFrames(0)
+    , m_totalFrameTime(0)
+    , m_maxFrameTime(0)
+    , m_lastFrameTime(0)
+{
+    QScreen *screen = qApp->primaryScreen();
+    if (screen && screen->refreshRate() > 1)
+        m_frameInterval = qMax(4, qRound(1000 / screen->refreshRate()));
+
+    m_clock.start();
+
+    m_frameTimer->setTimerType(Qt::PreciseTimer);
+    m_frameTimer->setInterval(m_frameInterval);
+    connect(m_frameTimer, &QTimer::timeout, this, &AnimationClock::onFrame);
+}
+
+qint64 AnimationClock::elapsed() const
+{
+    return m_clock.elapsed();
+}
+
+/**
+ * @brief AnimationClock::requestUpdate 在下一帧重绘控件或其中的 rect 区域，同一帧内的多次请求合并为一次重绘
+ */
+void AnimationClock::requestUpdate(QWidget *widget, const QRect &rect)
+{
+    auto it = m_pendingUpdates.find(widget);
+    if (it == m_pendingUpdates.end())
+        m_pendingUpdates.insert(widget, PendingUpdate { widget, rect });
+    else if (!it->region.isEmpty())
+        it->region = rect.isNull() ? QRegion() : it->region.united(rect);
+    scheduleFrame();
+}
+
+/**
+ * @brief AnimationClock::runOnFrame 在下一帧执行回调，同一 context 在一帧内只执行最后一次提交的回调
+ */
+void AnimationClock::runOnFrame(QObject *context, const std::function<void()> &callback)
+{
+    m_pendingCalls.insert(context, qMakePair(QPointer<QObject>(context), callback));
+    scheduleFrame();
+}
+
+/**
+ * @brief AnimationClock::flush 立即执行所有待处理的回调和重绘请求
+ */
+void AnimationClock::flush()
+{
+    const auto calls = m_pendingCalls;
+    m_pendingCalls.clear();
+    for (const auto &call : calls)
+        if (call.first)
+            call.second();
+
+    const QHash<QWidget *, PendingUpdate> updates = m_pendingUpdates;
+    m_pendingUpdates.clear();
+    for (const PendingUpdate &pending : updates) {
+        if (!pending.widget)
+            continue;
+        if (pending.region.isEmpty())
+            pending.widget->update();
+        else
+            pending.widget->update(pending.region);
+    }
+}
+
+QVariantMap AnimationClock::statistics() const
+{
+    QVariantMap result;
+    result.insert("running", isRunning());
+    result.insert("frameInterval", m_frameInterval);
+    result.insert("frames", m_frameCount);
+    result.insert("droppedFrames", m_droppedFrames);
+    result.insert("lastFrameTimeUs", m_lastFrameTime);
+    result.insert("maxFrameTimeUs", m_maxFrameTime);
+    result.insert("averageFrameTimeUs", m_frameCount ? qreal(m_totalFrameTime) / m_frameCount : 0.);
+    return result;
+}
+
+void AnimationClock::start()
+{
+    QAnimationDriver::start();
+    scheduleFrame();
+}
+
+/**
+ * @brief AnimationClock::onFrame 推进所有动画，再统一执行这一帧的回调（尺寸变化等）和重绘请求，
+ * 布局和绘制由 Qt 的 LayoutRequest/UpdateRequest 合并到这一帧结束后执行一次
+ */
+void AnimationClock::onFrame()
+{
+    PERF_SCOPE("animation", "AnimationClock");
+    const qint64 now = m_clock.elapsed();
+    if (m_lastFrame >= 0) {
+        const qint64 interval = now - m_lastFrame;
+        if (interval > m_frameInterval * 3 / 2)
+            m_droppedFrames += quint64(interval / m_frameInterval - 1);
+    }
+    m_lastFrame = now;
+
+    QElapsedTimer frameTimer;
+    frameTimer.start();
+
+    if (isRunning())
+        advance();
+
+    flush();
+
+    m_lastFrameTime = frameTimer.nsecsElapsed() / 1000;
+    m_totalFrameTime += m_lastFrameTime;
+    m_maxFrameTime = qMax(m_maxFrameTime, m_lastFrameTime);
+    ++m_frameCount;
+
+    // 空闲时停止计时，下次有动画或请求时重新开始计算丢帧
+    if (!isRunning() && m_pendingUpdates.isEmpty() && m_pendingCalls.isEmpty()) {
+        m_frameTimer->stop();
+        m_lastFrame = -1;
+    }
+}
+
+void AnimationClock::scheduleFrame()
+{
+    if (!m_frameTimer->isActive())
+        m_frameTimer->start();
+}
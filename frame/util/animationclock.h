@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef ANIMATIONCLOCK_H
+#define ANIMATIONCLOCK_H
+
+#include <QAnimationDriver>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QWidget>
+#include <QHash>
+#include <QVariantMap>
+
+#include <functional>
+
+class QTimer;
+
+/**
+ * @brief The AnimationClock class
+ * 任务栏所有动画共用的帧时钟。安装后替换 Qt 默认的动画驱动，按屏幕刷新率统一推进所有
+ * QVariantAnimation/QPropertyAnimation，并在同一帧内合并重绘请求和回调（如尺寸变化），
+ * 使每帧最多触发一次布局和一次绘制。没有动画和待处理请求时停止计时器。
+ */
+class AnimationClock : public QAnimationDriver
+{
+    Q_OBJECT
+public:
+    static AnimationClock *instance();
+
+    qint64 elapsed() const override;
+
+    void requestUpdate(QWidget *widget, const QRect &rect = QRect());
+    void runOnFrame(QObject *context, const std::function<void()> &callback);
+    void flush();
+
+    QVariantMap statistics() const;
+
+protected:
+    void start() override;
+
+private:
+    explicit AnimationClock();
+
+    void onFrame();
+    void scheduleFrame();
+
+private:
+    struct PendingUpdate {
+        QPointer<QWidget> widget;
+        QRegion region;     // 为空时重绘整个控件
+    };
+
+    QTimer *m_frameTimer;
+    QElapsedTimer m_clock;
+    int m_frameInterval;
+
+    QHash<QWidget *, PendingUpdate> m_pendingUpdates;
+    QHash<QObject *, QPair<QPointer<QObject>, std::function<void()>>> m_pendingCalls;
+
+    qint64 m_lastFrame;
+    quint64 m_frameCount;
+    quint64 m_droppedFrames;
+    qint64 m_totalFrameTime;    // 微秒
+    qint64 m_maxFrameTime;
+    qint64 m_lastFrameTime;
+};
+
+#endif // ANIMATIONCLOCK_H
@@ -60,12 +60,7 @@ QList<QScreen *> DisplayManager::screens() const
  */
 QScreen *DisplayManager::screen(const QString &screenName) const
 {
-    for (auto s : m_screens) {
-        if (s->name() == screenName)
-            return s;
-    }
-
-    return nullptr;
+    return m_screenNames.value(screenName);
 }
 
 /**
@@ -113,7 +108,27 @@ int DisplayManager::screenRawHeight() const
  */
 bool DisplayManager::canDock(QScreen *s, Position pos) const
 {
-    return s ? m_screenPositionMap[s].value(pos) : false;
+    return m_screenPositionMap.value(s) & (1 << pos);
+}
+
+/**
+ * @brief DisplayManager::screenAt
+ * @param point 设备像素坐标
+ * @return 包含该点的屏幕，否则返回nullptr
+ */
+QScreen *DisplayManager::screenAt(const QPoint &point) const
+{
+    const int index = m_layout.indexAt(point);
+    return index < 0 ? nullptr : m_layoutScreens.at(index);
+}
+
+/**
+ * @brief DisplayManager::isCopyMode
+ * @return 所有屏幕的起点相同时为复制模式
+ */
+bool DisplayManager::isCopyMode() const
+{
+    return m_layout.isCopyMode();
 }
 
 /**
@@ -122,169 +137,37 @@ bool DisplayManager::canDock(QScreen *s, Position pos) const
  */
 void DisplayManager::updateScreenDockInfo()
 {
-    // TODO 目前仅仅支持双屏，如果超过双屏，会出现异常，这里可以考虑做成通用的处理规则
-
     // 先清除原先的数据，然后再更新
     m_screenPositionMap.clear();
+    m_screenNames.clear();
+    m_layoutScreens.clear();
 
-    if (m_screens.isEmpty())
-        return;
-
-    // reset map
+    QVector<QRect> rects;
     for (auto s : m_screens) {
-        QMap <Position, bool> map;
-        map.insert(Position::Top, true);
-        map.insert(Position::Bottom, true);
-        map.insert(Position::Left, true);
-        map.insert(Position::Right, true);
-        m_screenPositionMap.insert(s, map);
-    }
+        QRect rect = s->geometry();
+        rect.setSize(rect.size() * s->devicePixelRatio());
+        rects << rect;
 
-    // 仅显示在主屏时的处理
-    if (m_onlyInPrimary) {
-        for (auto s : m_screens) {
-            if (s != qApp->primaryScreen()) {
-                QMap <Position, bool> map;
-                map.insert(Position::Top, false);
-                map.insert(Position::Bottom, false);
-                map.insert(Position::Left, false);
-                map.insert(Position::Right, false);
-                m_screenPositionMap.insert(s, map);
-            }
-        }
-        return;
+        m_screenNames.insert(s->name(), s);
+        m_layoutScreens << s;
     }
 
-    if (m_screens.size() == 1) {
+    m_layout.setRects(rects);
+    if (m_screens.isEmpty())
         return;
-    }
 
-    // 最多支持双屏,这里只计算双屏,单屏默认四边均可停靠任务栏
-    if (m_screens.size() == 2) {
-        QRect s0 = m_screens.at(0)->geometry();
-        s0.setSize(s0.size() * m_screens.at(0)->devicePixelRatio());
-        QRect s1 = m_screens.at(1)->geometry();
-        s1.setSize(s1.size() * m_screens.at(1)->devicePixelRatio());
-
-        qInfo() << "monitor info changed" << m_screens.at(0)->name() << s0 << m_screens.at(1)->name() << s1;
-
-        int s0top = s0.y();
-        int s0bottom = s0.y() + s0.height();
-        int s0left = s0.x();
-        int s0Right = s0.x() + s0.width();
-
-        int s1top = s1.y();
-        int s1bottom = s1.y() + s1.height();
-        int s1left = s1.x();
-        int s1Right = s1.x() + s1.width();
-
-        QPoint s0topLeft = QPoint(s0.x(), s0.y());
-        QPoint s0topRight = QPoint(s0.x()+ s0.width(), s0.y());
-        QPoint s0bottomRight = QPoint(s0.x()+ s0.width(), s0.y() + s0.height());
-        QPoint s0bottomLeft = QPoint(s0.x(), s0.y() + s0.height());
-
-        QPoint s1topLeft = QPoint(s1.x(), s1.y());
-        QPoint s1topRight = QPoint(s1.x() + s1.width(), s1.y());
-        QPoint s1bottomRight = QPoint(s1.x() + s1.width(), s1.y() + s1.height());
-        QPoint s1bottomLeft = QPoint(s1.x(), s1.y() + s1.height());
-
-        /*
-         * 对角拼接，重置，默认均可停靠
----------                       ---------
-|       |                       |       |
-|   s0  |                       |   s1  |
-|       |                       |       |
------------------               -----------------
-        |       |                       |       |
-        |   s1  |                           s0  |
-        |       |                       |       |
-        ---------                       ---------
-*/
-        if (s0bottomRight == s1topLeft
-                || s0topLeft == s1bottomRight) {
-            return;
-        }
+    qInfo() << "monitor info changed" << rects;
 
-        /*
-         * 左右拼接，s0左，s1右
----------------------               -------------
-|           |       |               |           |
-|           |  s1   |               |           |--------
-|     s0    |       |               |     s0    |       |
-|           |--------               |           |  s1   |
-|           |                       |           |       |
--------------                       ---------------------
-*/
-        if (s0Right == s1left
-                && (s0topRight == s1topLeft || s0bottomRight == s1bottomLeft)) {
-            m_screenPositionMap[m_screens.at(0)].insert(Position::Right, false);
-            m_screenPositionMap[m_screens.at(1)].insert(Position::Left, false);
-            return;
-        }
-
-        /*
-         * 左右拼接，s1左，s0右
----------------------               -------------
-|           |       |               |           |
-|           |  s0   |               |           |--------
-|     s1    |       |               |     s1    |       |
-|           |--------               |           |  s0   |
-|           |                       |           |       |
--------------                       ---------------------
-*/
-        if (s0left== s1Right
-                && (s0topLeft == s1topRight || s0bottomLeft == s1bottomRight)) {
-            m_screenPositionMap[m_screens.at(0)].insert(Position::Left, false);
-            m_screenPositionMap[m_screens.at(1)].insert(Position::Right, false);
-            return;
-        }
-
-        /*
-         * 上下拼接，s0上，s1下
----------                           ---------
-|       |                           |       |
-|   s0  |                           |   s0  |
-|       |                           |       |
--------------                   -------------
-|           |                   |           |
-|           |                   |           |
-|     s1    |                   |     s1    |
-|           |                   |           |
-|           |                   |           |
--------------                   -------------
-*/
-        if (s0bottom == s1top
-                && (s0bottomLeft == s1topLeft || s0bottomRight == s1topRight)) {
-            m_screenPositionMap[m_screens.at(0)].insert(Position::Bottom, false);
-            m_screenPositionMap[m_screens.at(1)].insert(Position::Top, false);
-            return;
-        }
-
-        /*
-         * 上下拼接，s1上，s0下
----------                   ---------
-|       |                   |       |
-|   s1  |                   |   s1  |
-|       |                   |       |
--------------           -------------
-|           |           |           |
-|           |           |           |
-|     s0    |           |     s0    |
-|           |           |           |
-|           |           |           |
--------------           -------------
-*/
-        if (s0top == s1bottom
-                && (s0topLeft == s1bottomLeft || s0topRight == s1bottomRight)) {
-            m_screenPositionMap[m_screens.at(0)].insert(Position::Top, false);
-            m_screenPositionMap[m_screens.at(1)].insert(Position::Bottom, false);
-            return;
-        }
+    // 仅显示在主屏时的处理
+    if (m_onlyInPrimary) {
+        for (auto s : m_screens)
+            m_screenPositionMap.insert(s, s == qApp->primaryScreen() ? ScreenLayout::AllEdges : 0);
         return;
     }
 
-    // 目前不支持链接超过两个以上的显示器
-    Q_UNREACHABLE();
+    const QVector<quint8> &edges = m_layout.dockableEdges();
+    for (int i = 0; i < m_screens.size(); ++i)
+        m_screenPositionMap.insert(m_screens.at(i), edges.at(i));
 }
 
 /**
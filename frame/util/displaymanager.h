@@ -23,8 +23,12 @@
 #define DISPLAYMANAGER_H
 
 #include <QObject>
+#include <QHash>
+#include <QRect>
+#include <QVector>
 
 #include "singleton.h"
+#include "screenlayout.h"
 #include "interfaces/constants.h"
 
 using namespace Dock;
@@ -45,6 +49,8 @@ public:
     int screenRawWidth() const;
     int screenRawHeight() const;
     bool canDock(QScreen *s, Position pos) const;
+    QScreen *screenAt(const QPoint &point) const;
+    bool isCopyMode() const;
 
 private:
     void updateScreenDockInfo();
@@ -60,7 +66,11 @@ Q_SIGNALS:
 
 private:
     QList <QScreen *> m_screens;
-    QMap <QScreen *, QMap <Position, bool>> m_screenPositionMap;
+    // 以下数据只在屏幕信息变化时重新计算
+    QHash<QScreen *, quint8> m_screenPositionMap;  // 可停靠的边，按位存放 1 << Position
+    QHash<QString, QScreen *> m_screenNames;
+    QVector<QScreen *> m_layoutScreens;             // 与 m_layout 中的序号对应
+    ScreenLayout m_layout;
     const QGSettings *m_gsettings;              // 多屏配置控制
     bool m_onlyInPrimary;
 };
@@ -15,179 +15,194 @@
 
 DCORE_USE_NAMESPACE
 
+static QStringList toStringList(const QVariant &value)
+{
+    QStringList ret;
+    for(const auto &var : value.toList()) {
+        if (var.isValid())
+            ret.push_back(var.toString());
+    }
+
+    return ret;
+}
+
 DockSettings::DockSettings(QObject *parent)
  : QObject (parent)
  , m_dockSettings(Settings::ConfigPtr(configDock))
+ , m_hits(0)
+ , m_misses(0)
 {
     init();
 }
 
 void DockSettings::init()
 {
+    static const QStringList keys = {
+        keyHideMode, keyPosition, keyForceQuitApp, keyIconSize, keyShowTimeout, keyHideTimeout,
+        keyWindowSizeFashion, keyDockedApps, keyRecentApp, keyWinIconPreferredApps,
+        keyShowRecent, keyShowMultiWindow, keyShowWindowName
+    };
+
     // 绑定属性
     if (m_dockSettings) {
+            for (const QString &key : keys)
+                loadValue(key);
+
             connect(m_dockSettings, &DConfig::valueChanged, this, [&] (const QString &key) {
+                loadValue(key);
+
                 if (key == keyHideMode) {
-                    Q_EMIT hideModeChanged(HideModeHandler(m_dockSettings->value(keyHideMode).toString()).toEnum());
+                    Q_EMIT hideModeChanged(m_cache.hideMode);
                 } else if (key == keyPosition) {
-                    Q_EMIT positionModeChanged(Position(PositionModeHandler(m_dockSettings->value(key).toString()).toEnum()));
+                    Q_EMIT positionModeChanged(m_cache.position);
                 } else if (key == keyForceQuitApp){
-                    Q_EMIT forceQuitAppChanged(ForceQuitAppModeHandler(m_dockSettings->value(key).toString()).toEnum());
+                    Q_EMIT forceQuitAppChanged(m_cache.forceQuitApp);
                 } else if (key == keyShowRecent) {
-                    Q_EMIT showRecentChanged(m_dockSettings->value(key).toBool());
+                    Q_EMIT showRecentChanged(m_cache.showRecent);
                 } else if (key == keyShowMultiWindow) {
-                    Q_EMIT showMultiWindowChanged(m_dockSettings->value(key).toBool());
+                    Q_EMIT showMultiWindowChanged(m_cache.showMultiWindow);
                 } else if ( key == keyShowWindowName) {
-                    Q_EMIT windowNameShowModeChanged(m_dockSettings->value(keyShowWindowName).toInt());
+                    Q_EMIT windowNameShowModeChanged(m_cache.windowNameShowMode);
                 } else if ( key == keyWindowSizeFashion) {
-                    Q_EMIT windowSizeFashionChanged(m_dockSettings->value(keyWindowSizeFashion).toUInt());
+                    Q_EMIT windowSizeFashionChanged(m_cache.windowSizeFashion);
                 }
             });
     }
 }
 
-HideMode DockSettings::getHideMode()
+void DockSettings::loadValue(const QString &key)
 {
-    if (m_dockSettings) {
-        QString mode = m_dockSettings->value(keyHideMode).toString();
-        HideModeHandler handler(mode);
-        return handler.toEnum();
+    ++m_misses;
+    updateCache(key, m_dockSettings->value(key));
+}
+
+void DockSettings::updateCache(const QString &key, const QVariant &value)
+{
+    if (key == keyHideMode) {
+        m_cache.hideMode = HideModeHandler(value.toString()).toEnum();
+    } else if (key == keyPosition) {
+        m_cache.position = PositionModeHandler(value.toString()).toEnum();
+    } else if (key == keyForceQuitApp) {
+        m_cache.forceQuitApp = ForceQuitAppModeHandler(value.toString()).toEnum();
+    } else if (key == keyIconSize) {
+        m_cache.iconSize = value.toUInt();
+    } else if (key == keyShowTimeout) {
+        m_cache.showTimeout = value.toUInt();
+    } else if (key == keyHideTimeout) {
+        m_cache.hideTimeout = value.toUInt();
+    } else if (key == keyWindowSizeFashion) {
+        m_cache.windowSizeFashion = value.toUInt();
+    } else if (key == keyDockedApps) {
+        m_cache.dockedApps = toStringList(value);
+    } else if (key == keyRecentApp) {
+        m_cache.recentApps = toStringList(value);
+    } else if (key == keyWinIconPreferredApps) {
+        m_cache.winIconPreferredApps = toStringList(value).toVector();
+    } else if (key == keyShowRecent) {
+        m_cache.showRecent = value.toBool();
+    } else if (key == keyShowMultiWindow) {
+        m_cache.showMultiWindow = value.toBool();
+    } else if (key == keyShowWindowName) {
+        m_cache.windowNameShowMode = value.toInt();
     }
-    return HideMode::KeepShowing;
+}
+
+// 写入后立即更新缓存，变化信号仍由 valueChanged 发出
+void DockSettings::setValue(const QString &key, const QVariant &value)
+{
+    if (!m_dockSettings)
+        return;
+
+    m_dockSettings->setValue(key, value);
+    updateCache(key, value);
+}
+
+HideMode DockSettings::getHideMode() const
+{
+    ++m_hits;
+    return m_cache.hideMode;
 }
 
 void DockSettings::setHideMode(HideMode mode)
 {
-    if (m_dockSettings) {
-        m_dockSettings->setValue(keyHideMode, HideModeHandler(mode).toString());
-    }
+    setValue(keyHideMode, HideModeHandler(mode).toString());
 }
 
-Position DockSettings::getPositionMode()
+Position DockSettings::getPositionMode() const
 {
-    Position ret = Position::Bottom;
-    if (m_dockSettings) {
-        QString mode = m_dockSettings->value(keyPosition).toString();
-        PositionModeHandler handler(mode);
-        ret = handler.toEnum();
-    }
-    return ret;
+    ++m_hits;
+    return m_cache.position;
 }
 
 void DockSettings::setPositionMode(Position mode)
 {
-    if (m_dockSettings) {
-        m_dockSettings->setValue(keyPosition, PositionModeHandler(mode).toString());
-    }
+    setValue(keyPosition, PositionModeHandler(mode).toString());
 }
 
-ForceQuitAppMode DockSettings::getForceQuitAppMode()
+ForceQuitAppMode DockSettings::getForceQuitAppMode() const
 {
-    ForceQuitAppMode ret = ForceQuitAppMode::Enabled;
-    if (m_dockSettings) {
-        QString mode = m_dockSettings->value(keyForceQuitApp).toString();
-        ForceQuitAppModeHandler handler(mode);
-        ret = handler.toEnum();
-    }
-    return ret;
+    ++m_hits;
+    return m_cache.forceQuitApp;
 }
 
 void DockSettings::setForceQuitAppMode(ForceQuitAppMode mode)
 {
-    if (m_dockSettings) {
-        m_dockSettings->setValue(keyForceQuitApp, ForceQuitAppModeHandler(mode).toString());
-    }
+    setValue(keyForceQuitApp, ForceQuitAppModeHandler(mode).toString());
 }
 
-uint DockSettings::getIconSize()
+uint DockSettings::getIconSize() const
 {
-    uint size = 36;
-    if (m_dockSettings) {
-        size = m_dockSettings->value(keyIconSize).toUInt();
-    }
-    return size;
+    ++m_hits;
+    return m_cache.iconSize;
 }
 
 void DockSettings::setIconSize(uint size)
 {
-    if (m_dockSettings) {
-        m_dockSettings->setValue(keyIconSize, size);
-    }
+    setValue(keyIconSize, size);
 }
 
-uint DockSettings::getShowTimeout()
+uint DockSettings::getShowTimeout() const
 {
-    uint time = 100;
-    if (m_dockSettings) {
-        time = m_dockSettings->value(keyShowTimeout).toUInt();
-    }
-    return time;
+    ++m_hits;
+    return m_cache.showTimeout;
 }
 
 void DockSettings::setShowTimeout(uint time)
 {
-    if (m_dockSettings) {
-        m_dockSettings->setValue(keyShowTimeout, time);
-    }
+    setValue(keyShowTimeout, time);
 }
 
-uint DockSettings::getHideTimeout()
+uint DockSettings::getHideTimeout() const
 {
-    uint time = 0;
-    if (m_dockSettings) {
-        time = m_dockSettings->value(keyHideTimeout).toUInt();
-    }
-    return time;
+    ++m_hits;
+    return m_cache.hideTimeout;
 }
 
 void DockSettings::setHideTimeout(uint time)
 {
-    if (m_dockSettings) {
-        m_dockSettings->setValue(keyHideTimeout, time);
-    }
+    setValue(keyHideTimeout, time);
 }
 
-uint DockSettings::getWindowSizeFashion()
+uint DockSettings::getWindowSizeFashion() const
 {
-    uint size = 48;
-    if (m_dockSettings) {
-        size = m_dockSettings->value(keyWindowSizeFashion).toUInt();
-    }
-    return size;
+    ++m_hits;
+    return m_cache.windowSizeFashion;
 }
 
 void DockSettings::setWindowSizeFashion(uint size)
 {
-    if (m_dockSettings) {
-        m_dockSettings->setValue(keyWindowSizeFashion, size);
-    }
+    setValue(keyWindowSizeFashion, size);
 }
 
 void DockSettings::saveStringList(const QString &key, const QStringList &values)
 {
-    if (!m_dockSettings)
-        return;
-
-    m_dockSettings->setValue(key, values);
+    setValue(key, values);
 }
 
-QStringList DockSettings::loadStringList(const QString &key) const
+const QStringList &DockSettings::getDockedApps() const
 {
-    QStringList ret;
-    if (!m_dockSettings)
-        return ret;
-
-    for(const auto &var : m_dockSettings->value(key).toList()) {
-        if (var.isValid())
-            ret.push_back(var.toString());
-    }
-
-    return ret;
-}
-
-QStringList DockSettings::getDockedApps()
-{
-    return loadStringList(keyDockedApps);
+    ++m_hits;
+    return m_cache.dockedApps;
 }
 
 void DockSettings::setDockedApps(const QStringList &apps)
@@ -195,9 +210,10 @@ void DockSettings::setDockedApps(const QStringList &apps)
     saveStringList(keyDockedApps, apps);
 }
 
-QStringList DockSettings::getRecentApps() const
+const QStringList &DockSettings::getRecentApps() const
 {
-    return loadStringList(keyRecentApp);
+    ++m_hits;
+    return m_cache.recentApps;
 }
 
 void DockSettings::setRecentApps(const QStringList &apps)
@@ -205,61 +221,49 @@ void DockSettings::setRecentApps(const QStringList &apps)
     saveStringList(keyRecentApp, apps);
 }
 
-QVector<QString> DockSettings::getWinIconPreferredApps()
+const QVector<QString> &DockSettings::getWinIconPreferredApps() const
 {
-    QVector<QString> ret;
-    if (m_dockSettings) {
-        for(const auto &var : m_dockSettings->value(keyWinIconPreferredApps).toList()) {
-            if (var.isValid())
-                ret.push_back(var.toString());
-        }
-    }
-
-    return ret;
+    ++m_hits;
+    return m_cache.winIconPreferredApps;
 }
 
 void DockSettings::setShowRecent(bool visible)
 {
-    if (!m_dockSettings)
-        return;
-
-    m_dockSettings->setValue(keyShowRecent, visible);
+    setValue(keyShowRecent, visible);
 }
 
 bool DockSettings::showRecent() const
 {
-    if (!m_dockSettings)
-        return false;
-
-    return m_dockSettings->value(keyShowRecent).toBool();
+    ++m_hits;
+    return m_cache.showRecent;
 }
 
 void DockSettings::setShowMultiWindow(bool showMultiWindow)
 {
-    if (!m_dockSettings)
-        return;
-
-    m_dockSettings->setValue(keyShowMultiWindow, showMultiWindow);
+    setValue(keyShowMultiWindow, showMultiWindow);
 }
 
 bool DockSettings::showMultiWindow() const
 {
-    if (!m_dockSettings)
-        return false;
-
-    return m_dockSettings->value(keyShowMultiWindow).toBool();
+    ++m_hits;
+    return m_cache.showMultiWindow;
 }
 
-int DockSettings::getWindowNameShowMode()
+int DockSettings::getWindowNameShowMode() const
 {
-    if (!m_dockSettings)
-        return 0;
-    return m_dockSettings->value(keyShowWindowName).toInt();
+    ++m_hits;
+    return m_cache.windowNameShowMode;
 }
 
 void DockSettings::setWindowNameShowMode(int value)
 {
-    if (!m_dockSettings)
-        return;
-    m_dockSettings->setValue(keyShowWindowName, value);
+    setValue(keyShowWindowName, value);
+}
+
+QVariantMap DockSettings::statistics() const
+{
+    QVariantMap statistics;
+    statistics.insert("hits", m_hits);
+    statistics.insert("misses", m_misses);
+    return statistics;
 }
@@ -8,6 +8,8 @@
 #include "../interfaces/constants.h"
 
 #include <QObject>
+#include <QVector>
+#include <QVariantMap>
 
 using namespace Dock;
 
@@ -151,34 +153,36 @@ public:
     }
     void init();
 
-    HideMode getHideMode();
+    HideMode getHideMode() const;
     void setHideMode(HideMode mode);
-    Position getPositionMode();
+    Position getPositionMode() const;
     void setPositionMode(Position mode);
-    ForceQuitAppMode getForceQuitAppMode();
+    ForceQuitAppMode getForceQuitAppMode() const;
     void setForceQuitAppMode(ForceQuitAppMode mode);
-    uint getIconSize();
+    uint getIconSize() const;
     void setIconSize(uint size);
-    uint getShowTimeout();
+    uint getShowTimeout() const;
     void setShowTimeout(uint time);
-    uint getHideTimeout();
+    uint getHideTimeout() const;
     void setHideTimeout(uint time);
-    uint getWindowSizeFashion();
+    uint getWindowSizeFashion() const;
     void setWindowSizeFashion(uint size);
-    QStringList getDockedApps();
+    const QStringList &getDockedApps() const;
     void setDockedApps(const QStringList &apps);
-    QStringList getRecentApps() const;
+    const QStringList &getRecentApps() const;
     void setRecentApps(const QStringList &apps);
-    QVector<QString> getWinIconPreferredApps();
+    const QVector<QString> &getWinIconPreferredApps() const;
     void setShowRecent(bool visible);
     bool showRecent() const;
 
-    int  getWindowNameShowMode();
+    int  getWindowNameShowMode() const;
     void setWindowNameShowMode(int value);
 
     void setShowMultiWindow(bool showMultiWindow);
     bool showMultiWindow() const;
 
+    QVariantMap statistics() const;
+
 Q_SIGNALS:
     // 隐藏模式改变
     void hideModeChanged(HideMode mode);
@@ -200,10 +204,32 @@ private:
     DockSettings(const DockSettings &);
     DockSettings& operator= (const DockSettings &);
     void saveStringList(const QString &key, const QStringList &values);
-    QStringList loadStringList(const QString &key) const;
+    void loadValue(const QString &key);
+    void updateCache(const QString &key, const QVariant &value);
+    void setValue(const QString &key, const QVariant &value);
 
 private:
+    // 所有配置项的缓存，启动时读取一次，之后只在 valueChanged 时更新
+    struct Cache {
+        HideMode hideMode = HideMode::KeepShowing;
+        Position position = Position::Bottom;
+        ForceQuitAppMode forceQuitApp = ForceQuitAppMode::Enabled;
+        uint iconSize = 36;
+        uint showTimeout = 100;
+        uint hideTimeout = 0;
+        uint windowSizeFashion = 48;
+        QStringList dockedApps;
+        QStringList recentApps;
+        QVector<QString> winIconPreferredApps;
+        bool showRecent = false;
+        bool showMultiWindow = false;
+        int windowNameShowMode = 0;
+    };
+
     DConfig *m_dockSettings;
+    Cache m_cache;
+    mutable quint64 m_hits;         // 从缓存返回的次数
+    quint64 m_misses;               // 从 DConfig 读取的次数
 };
 
 #endif // DOCKSETTINGS_H
@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "edgemonitor.h"
+
+#include <QSocketNotifier>
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include <X11/Xlib.h>
+#include <X11/extensions/Xfixes.h>
+#include <X11/extensions/XInput2.h>
+
+EdgeMonitor::EdgeMonitor(QObject *parent)
+    : QObject(parent)
+    , m_display(nullptr)
+    , m_xiOpcode(0)
+    , m_notifier(nullptr)
+{
+    // XWayland 下屏障收不到真实的鼠标移动，仍然使用 XEventMonitor
+    if (qgetenv("XDG_SESSION_TYPE") == "wayland")
+        return;
+
+    m_display = XOpenDisplay(nullptr);
+    if (!m_display) {
+        qWarning() << "open X display for edge monitor failed!";
+        return;
+    }
+
+    int event, error;
+    int major = 5, minor = 0;
+    if (!XFixesQueryExtension(m_display, &event, &error) || !XFixesQueryVersion(m_display, &major, &minor) || major < 5) {
+        qInfo() << "XFixes pointer barrier is not supported, use XEventMonitor instead";
+        return;
+    }
+
+    major = 2;
+    minor = 3;
+    if (!XQueryExtension(m_display, "XInputExtension", &m_xiOpcode, &event, &error)
+            || XIQueryVersion(m_display, &major, &minor) != Success || major * 10 + minor < 23) {
+        qInfo() << "XInput 2.3 is not supported, use XEventMonitor instead";
+        return;
+    }
+
+    unsigned char bits[XIMaskLen(XI_LASTEVENT)] = { 0 };
+    XIEventMask mask;
+    mask.deviceid = XIAllMasterDevices;
+    mask.mask_len = sizeof(bits);
+    mask.mask = bits;
+    XISetMask(bits, XI_BarrierHit);
+    XISelectEvents(m_display, DefaultRootWindow(m_display), &mask, 1);
+    XFlush(m_display);
+
+    m_notifier = new QSocketNotifier(ConnectionNumber(m_display), QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &EdgeMonitor::processEvents);
+}
+
+EdgeMonitor::~EdgeMonitor()
+{
+    if (m_display) {
+        clearBarriers();
+        XCloseDisplay(m_display);
+    }
+}
+
+/**
+ * @brief EdgeMonitor::barrierLines 计算每个可停靠屏幕任务栏所在边缘上需要放置屏障的线段
+ * 边缘外侧被其他屏幕覆盖的部分鼠标可以继续移过去，不能放屏障，否则鼠标会被挡住
+ * @param dockRects 可停靠屏幕的区域，单位为设备像素
+ * @param screenRects 所有屏幕的区域
+ * @param position 任务栏位置，Top 和监听区域一样按 Bottom 处理
+ */
+QVector<QLine> EdgeMonitor::barrierLines(const QList<QRect> &dockRects, const QList<QRect> &screenRects, Dock::Position position)
+{
+    QVector<QLine> lines;
+    const bool horizontal = position == Dock::Top || position == Dock::Bottom;
+
+    for (const QRect &rect : dockRects) {
+        // 边缘外侧紧挨着的一行（列）像素
+        int outside = 0;
+        switch (position) {
+        case Dock::Top:
+        case Dock::Bottom:  outside = rect.y() + rect.height(); break;
+        case Dock::Left:    outside = rect.x() - 1;             break;
+        case Dock::Right:   outside = rect.x() + rect.width();  break;
+        }
+
+        // [begin, end) 区间减去其他屏幕覆盖的部分
+        QVector<QPair<int, int>> spans { horizontal ? qMakePair(rect.x(), rect.x() + rect.width())
+                                                    : qMakePair(rect.y(), rect.y() + rect.height()) };
+        for (const QRect &other : screenRects) {
+            if (other == rect)
+                continue;
+
+            const bool covers = horizontal ? (other.top() <= outside && outside <= other.bottom())
+                                           : (other.left() <= outside && outside <= other.right());
+            if (!covers)
+                continue;
+
+            const int coverBegin = horizontal ? other.x() : other.y();
+            const int coverEnd = coverBegin + (horizontal ? other.width() : other.height());
+
+            QVector<QPair<int, int>> remains;
+            for (const auto &span : spans) {
+                if (coverEnd <= span.first || span.second <= coverBegin) {
+                    remains << span;
+                    continue;
+                }
+                if (span.first < coverBegin)
+                    remains << qMakePair(span.first, coverBegin);
+                if (coverEnd < span.second)
+                    remains << qMakePair(coverEnd, span.second);
+            }
+            spans = remains;
+        }
+
+        const int edge = position == Dock::Left ? rect.x() : outside;
+        for (const auto &span : spans) {
+            if (horizontal)
+                lines << QLine(span.first, edge, span.second, edge);
+            else
+                lines << QLine(edge, span.first, edge, span.second);
+        }
+    }
+
+    return lines;
+}
+
+/**
+ * @brief EdgeMonitor::setEdges 在任务栏所在的边缘外侧放置只阻挡离开屏幕方向的屏障，参数同 barrierLines
+ */
+void EdgeMonitor::setEdges(const QList<QRect> &dockRects, const QList<QRect> &screenRects, Dock::Position position)
+{
+    if (!isValid())
+        return;
+
+    clearBarriers();
+
+    int directions = 0;
+    switch (position) {
+    case Dock::Top:
+    case Dock::Bottom:  directions = BarrierNegativeY; break;
+    case Dock::Left:    directions = BarrierPositiveX; break;
+    case Dock::Right:   directions = BarrierNegativeX; break;
+    }
+
+    const Window root = DefaultRootWindow(m_display);
+    for (const QLine &line : barrierLines(dockRects, screenRects, position))
+        m_barriers << XFixesCreatePointerBarrier(m_display, root, line.x1(), line.y1(), line.x2(), line.y2(), directions, 0, nullptr);
+
+    XFlush(m_display);
+}
+
+void EdgeMonitor::clearBarriers()
+{
+    for (const unsigned long barrier : m_barriers)
+        XFixesDestroyPointerBarrier(m_display, barrier);
+    m_barriers.clear();
+
+    XFlush(m_display);
+}
+
+void EdgeMonitor::processEvents()
+{
+    QElapsedTimer clock;
+    clock.start();
+    const qint64 now = clock.msecsSinceReference();
+
+    bool hit = false;
+    QPoint pos;
+    qint64 timestamp = 0;
+
+    // 推着边缘移动时每次移动都会产生事件，一批事件只处理最后一个
+    while (XPending(m_display)) {
+        XEvent event;
+        XNextEvent(m_display, &event);
+
+        XGenericEventCookie *cookie = &event.xcookie;
+        if (cookie->type != GenericEvent || cookie->extension != m_xiOpcode || !XGetEventData(m_display, cookie))
+            continue;
+
+        if (cookie->evtype == XI_BarrierHit) {
+            const XIBarrierEvent *barrierEvent = static_cast<const XIBarrierEvent *>(cookie->data);
+            // X 的事件时间也是单调时钟毫秒数，但只有 32 位，按差值换算回来
+            hit = true;
+            pos = QPoint(qRound(barrierEvent->root_x), qRound(barrierEvent->root_y));
+            timestamp = now - quint32(quint32(now) - quint32(barrierEvent->time));
+        }
+
+        XFreeEventData(m_display, cookie);
+    }
+
+    if (hit)
+        emit edgeHit(pos, timestamp);
+}
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef EDGEMONITOR_H
+#define EDGEMONITOR_H
+
+#include "interfaces/constants.h"
+
+#include <QObject>
+#include <QList>
+#include <QLine>
+#include <QRect>
+#include <QVector>
+
+class QSocketNotifier;
+struct _XDisplay;
+typedef _XDisplay Display;
+
+/**
+ * @brief The EdgeMonitor class
+ * 在任务栏可停靠的屏幕边缘放置 XFixes 指针屏障，鼠标推向边缘时由 X 直接发送 XI_BarrierHit 事件，
+ * 不需要 XEventMonitor 通过 DBus 转发鼠标移动。X 不支持 XFixes 5 或 XInput 2.3 时 isValid() 为 false
+ */
+class EdgeMonitor : public QObject
+{
+    Q_OBJECT
+public:
+    explicit EdgeMonitor(QObject *parent = nullptr);
+    ~EdgeMonitor();
+
+    bool isValid() const { return m_notifier; }
+    void setEdges(const QList<QRect> &dockRects, const QList<QRect> &screenRects, Dock::Position position);
+
+    static QVector<QLine> barrierLines(const QList<QRect> &dockRects, const QList<QRect> &screenRects, Dock::Position position);
+
+signals:
+    // pos 为设备像素坐标，timestamp 为事件在 X 中产生的单调时钟毫秒数
+    void edgeHit(const QPoint &pos, qint64 timestamp) const;
+
+private:
+    void clearBarriers();
+    void processEvents();
+
+private:
+    Display *m_display;
+    int m_xiOpcode;
+    QSocketNotifier *m_notifier;
+    QVector<unsigned long> m_barriers;
+};
+
+#endif // EDGEMONITOR_H
@@ -29,6 +29,8 @@
 #include "org_deepin_dde_appearance1.h"
 #include "docksettings.h"
 #include "window/dockitemmanager.h"
+#include "edgemonitor.h"
+#include "perfstatistics.h"
 
 #include <QWidget>
 #include <QScreen>
@@ -39,6 +41,7 @@
 #include <QDBusConnection>
 #include <qpa/qplatformscreen.h>
 #include <QApplication>
+#include <QElapsedTimer>
 
 using Appearance = org::deepin::dde::Appearance1;
 
@@ -86,6 +89,9 @@ MultiScreenWorker::MultiScreenWorker(MainWindow *parent) : QObject(parent)
     , m_parent(parent)
     , m_eventInter(nullptr)
     , m_extralEventInter(nullptr)
+    , m_edgeMonitor(new EdgeMonitor(this))
+    , m_edgeHitTime(0)
+    , m_frameMoveTime(0)
     , m_launcherInter(nullptr)
     , m_delayWakeTimer(new QTimer(this))
     , m_state(AutoHide)
@@ -95,14 +101,22 @@ MultiScreenWorker::MultiScreenWorker(MainWindow *parent) : QObject(parent)
     m_delayWakeTimer->setSingleShot(true);
     m_delayWakeTimer->setInterval(Utils::SettingValue("com.deepin.dde.dock.mainwindow", "/com/deepin/dde/dock/mainwindow/", MonitorsSwitchTime, 2000).toInt());
 
-    ani = new QPropertyAnimation(m_parent, "pos", this);
+    ani = new QVariantAnimation(this);
     ani->setDuration(300);
     ani->setEasingCurve(QEasingCurve::InOutCubic);
-    connect(ani, &QPropertyAnimation::finished, this, [this]{
-        if(ani->direction() == QPropertyAnimation::Backward) m_parent->hide();
+    connect(ani, &QVariantAnimation::valueChanged, this, &MultiScreenWorker::onAnimationValueChanged);
+    connect(ani, &QVariantAnimation::finished, this, [this]{
+        recordAnimationFrame(false);
+        m_parent->setSnapshotMode(false);
+        if(ani->direction() == QVariantAnimation::Backward) m_parent->hide();
         setStates(ShowAnimationStart, false);
         setStates(HideAnimationStart, false);
     });
+    connect(m_parent, &MainWindow::framePainted, this, [this] {
+        // 只统计动画期间的绘制，悬停等引起的重绘不计入
+        if (m_frameAnimation && m_frameAnimation->state() == QAbstractAnimation::Running)
+            recordAnimationFrame(true);
+    });
 
     m_launcherInter = new LauncherInter("org.deepin.dde.Launcher1", "/org/deepin/dde/Launcher1", QDBusConnection::sessionBus(), this);
 
@@ -111,6 +125,8 @@ MultiScreenWorker::MultiScreenWorker(MainWindow *parent) : QObject(parent)
     initConnection();
     checkXEventMonitorService();
 
+    connect(m_edgeMonitor, &EdgeMonitor::edgeHit, this, &MultiScreenWorker::onEdgeCursorMove);
+
     // init data
     m_position = DockSettings::instance()->getPositionMode();
     m_hideMode = DockSettings::instance()->getHideMode();
@@ -193,6 +209,9 @@ void MultiScreenWorker::initShow()
             displayAnimation(AniAction::Show);
         else if (m_hideMode == HideMode::KeepHidden || m_hideState == HideState::Hide)
             displayAnimation(AniAction::Hide);
+
+        // 指针屏障不依赖 XEventMonitor 服务，初始化完成后直接设置
+        onRequestUpdateRegionMonitor();
     }
 }
 
@@ -222,7 +241,7 @@ void MultiScreenWorker::setWindowSize(int size)
 void MultiScreenWorker::onAutoHideChanged(bool autoHide)
 {
     setStates(AutoHide, autoHide);
-    if(autoHide && m_hideMode != KeepShowing && m_hideState == HideState::Hide && m_parent->isVisible() && !m_parent->underMouse() && ani->state() == QPropertyAnimation::Stopped)
+    if(autoHide && m_hideMode != KeepShowing && m_hideState == HideState::Hide && m_parent->isVisible() && !m_parent->underMouse() && ani->state() == QVariantAnimation::Stopped)
         displayAnimation(AniAction::Hide);
 }
 
@@ -243,17 +262,23 @@ void MultiScreenWorker::updateDaemonDockSize(int dockSize)
 
 void MultiScreenWorker::updateDisplay()
 {
-    if (ani->state() == QPropertyAnimation::Stopped) {
+    if (ani->state() == QVariantAnimation::Stopped) {
         const QRect rect = getDockShowGeometry(DOCK_SCREEN->current(), m_position);
         if(!m_parent->isHidden()) {
             // m_parent->setGeometry(rect);
-            auto animation = new QPropertyAnimation(m_parent, "geometry", this);
+            auto animation = new QVariantAnimation(this);
             animation->setEasingCurve(QEasingCurve::InOutCubic);
             animation->setStartValue(m_parent->geometry());
             animation->setEndValue(rect);
             animation->setDuration(100);
-            connect(animation, &QPropertyAnimation::finished, this, &MultiScreenWorker::requestUpdateFrontendGeometry);
-            animation->start(QPropertyAnimation::DeleteWhenStopped);
+            connect(animation, &QVariantAnimation::valueChanged, this, &MultiScreenWorker::onAnimationValueChanged);
+            connect(animation, &QVariantAnimation::finished, this, [this] {
+                recordAnimationFrame(false);
+                m_parent->setSnapshotMode(false);
+            });
+            connect(animation, &QVariantAnimation::finished, this, &MultiScreenWorker::requestUpdateFrontendGeometry);
+            m_parent->setSnapshotMode(true);
+            animation->start(QVariantAnimation::DeleteWhenStopped);
         } else {
             m_parent->resize(rect.size());
             emit requestUpdateFrontendGeometry();
@@ -269,6 +294,25 @@ void MultiScreenWorker::updateDisplay()
  */
 void MultiScreenWorker::onRequestUpdateRegionMonitor()
 {
+    // 优先在进程内用指针屏障检测唤起，不再让 XEventMonitor 转发边缘区域内的鼠标移动
+    // 复制模式下各屏幕互相重叠，小屏幕的边缘位于大屏幕内部，放屏障会挡住鼠标，仍然使用 XEventMonitor
+    const bool useBarriers = m_edgeMonitor->isValid() && !DIS_INS->isCopyMode();
+    if (m_edgeMonitor->isValid()) {
+        QList<QRect> edges;
+        QList<QRect> screens;
+        if (useBarriers && (DIS_INS->screens().size() != 1 || m_hideMode != KeepShowing)) {
+            for (auto s : DIS_INS->screens()) {
+                QRect screenRect = s->geometry();
+                screenRect.setSize(screenRect.size() * s->devicePixelRatio());
+                screens << screenRect;
+
+                if (DIS_INS->canDock(s, m_position))
+                    edges << screenRect;
+            }
+        }
+        m_edgeMonitor->setEdges(edges, screens, m_position);
+    }
+
     if(!m_eventInter || !m_extralEventInter) return;
 
     if (!m_registerKey.isEmpty()) {
@@ -363,31 +407,11 @@ void MultiScreenWorker::onRequestUpdateRegionMonitor()
         m_extralRectList << monitorRect;
     }
 
-    m_registerKey = m_eventInter->RegisterAreas(m_monitorRectList, flags);
+    if (!useBarriers)
+        m_registerKey = m_eventInter->RegisterAreas(m_monitorRectList, flags);
     m_extralRegisterKey = m_extralEventInter->RegisterAreas(m_extralRectList, flags);
 }
 
-/**
- * @brief 判断屏幕是否为复制模式的依据，第一个屏幕的X和Y值是否和其他的屏幕的X和Y值相等
- * 对于复制模式，这两个值肯定是相等的，如果不是复制模式，这两个值肯定不等，目前支持双屏
- */
-bool MultiScreenWorker::isCopyMode()
-{
-    QList<QScreen *> screens = DIS_INS->screens();
-    if (screens.size() < 2)
-        return false;
-
-    // 在多个屏幕的情况下，如果所有屏幕的位置的X和Y值都相等，则认为是复制模式
-    QRect rect0 = screens[0]->availableGeometry();
-    for (int i = 1; i < screens.size(); i++) {
-        QRect rect = screens[i]->availableGeometry();
-        if (rect0.x() != rect.x() || rect0.y() != rect.y())
-            return false;
-    }
-
-    return true;
-}
-
 /**
  * @brief 这里用到xcb去设置任务栏的高度，比较特殊，参考_NET_WM_STRUT_PARTIAL属性
  * 在屏幕旋转后，所有参数以控制中心自定义设置里主屏显示的图示为准（旋转不用特殊处理）
@@ -399,7 +423,7 @@ void MultiScreenWorker::requestNotifyWindowManager()
     static int lastScreenHeight = 0;
 
     /* 在非主屏或非一直显示状态时，清除任务栏区域，不挤占应用 */
-    if (m_hideMode != HideMode::KeepShowing || (!isCopyMode() && DOCK_SCREEN->current() != DOCK_SCREEN->primary())) {
+    if (m_hideMode != HideMode::KeepShowing || (!DIS_INS->isCopyMode() && DOCK_SCREEN->current() != DOCK_SCREEN->primary())) {
         lastRect = QRect();
 
         if (QX11Info::display()) XcbMisc::instance()->clear_strut_partial(xcb_window_t(m_parent->winId()));
@@ -493,7 +517,7 @@ void MultiScreenWorker::initConnection()
         if (testState(LauncherDisplay) || testState(ChangePositionAnimationStart)) return;
 
         // 复制模式．不需要响应切换屏幕
-        if (DIS_INS->screens().size() == 2 && DIS_INS->screens().first()->geometry() == DIS_INS->screens().last()->geometry()) {
+        if (DIS_INS->isCopyMode()) {
             QRect rect = getDockShowGeometry(DOCK_SCREEN->current(), m_position);
             if(m_parent->isHidden()) rect = getDockHideGeometry(rect, m_position);
             m_parent->setGeometry(rect);
@@ -535,8 +559,19 @@ void MultiScreenWorker::displayAnimation(const QString &screen, const Position &
 
     if(testState(ChangePositionAnimationStart) == false)
         setStates(act == AniAction::Show ? ShowAnimationStart : HideAnimationStart);
+    m_parent->setSnapshotMode(true);
     ani->start();
     if(act == AniAction::Show) m_parent->show();
+
+#ifdef ENABLE_PERF_TIMERS
+    // 只有指针屏障带有事件产生的时间，XEventMonitor 的信号没有时间戳，不统计
+    if (act == AniAction::Show && m_edgeHitTime) {
+        QElapsedTimer clock;
+        clock.start();
+        PerfStatistics::instance()->record("edge", "barrier", (clock.msecsSinceReference() - m_edgeHitTime) * 1000000);
+    }
+#endif
+    m_edgeHitTime = 0;
 }
 
 /**
@@ -570,7 +605,7 @@ void MultiScreenWorker::changeDockPosition(QString fromScreen, QString toScreen,
     DOCK_SCREEN->updateDockedScreen(toScreen);
 
     static QObject *conn(new QObject(this));
-    connect(ani, &QPropertyAnimation::finished, conn, [this, fromPos, toPos, toScreen] {
+    connect(ani, &QVariantAnimation::finished, conn, [this, fromPos, toPos, toScreen] {
         ani->disconnect(conn);
 
         // 如果更改了显示位置，在显示之前应该更新一下界面布局方向
@@ -580,7 +615,7 @@ void MultiScreenWorker::changeDockPosition(QString fromScreen, QString toScreen,
             m_parent->panel()->setPositonValue(toPos);
         }
 
-        connect(ani, &QPropertyAnimation::finished, conn, [ this ] {
+        connect(ani, &QVariantAnimation::finished, conn, [ this ] {
             setStates(ChangePositionAnimationStart, false);
             // conn->deleteLater();
 
@@ -625,7 +660,7 @@ QString MultiScreenWorker::getValidScreen()
  */
 void MultiScreenWorker::resetDockScreen()
 {
-    if (ani->state() == QPropertyAnimation::Running || testState(ChangePositionAnimationStart)) return;
+    if (ani->state() == QVariantAnimation::Running || testState(ChangePositionAnimationStart)) return;
 
     DOCK_SCREEN->updateDockedScreen(getValidScreen());
     // 更新任务栏自身信息
@@ -680,6 +715,89 @@ bool MultiScreenWorker::isCursorOut(int x, int y)
     return false;
 }
 
+/**
+ * @brief onAnimationValueChanged 显示隐藏和尺寸动画的每一帧在这里移动窗口，并开始统计这一帧的耗时
+ * @param value 位置动画为 QPoint，尺寸动画为 QRect
+ */
+void MultiScreenWorker::onAnimationValueChanged(const QVariant &value)
+{
+    // QVariantAnimation 在停止状态下设置起止值时也会发出 valueChanged，此时不能移动窗口
+    QVariantAnimation *animation = static_cast<QVariantAnimation *>(sender());
+    if (animation->state() != QAbstractAnimation::Running)
+        return;
+
+    m_frameAnimation = animation;
+
+#ifdef ENABLE_PERF_TIMERS
+    // 上一帧没有触发绘制，只统计移动窗口的耗时
+    recordAnimationFrame(false);
+    m_frameTimer.start();
+#endif
+
+    if (value.type() == QVariant::Rect)
+        m_parent->setGeometry(value.toRect());
+    else
+        m_parent->move(value.toPoint());
+
+#ifdef ENABLE_PERF_TIMERS
+    m_frameMoveTime = m_frameTimer.nsecsElapsed();
+#endif
+}
+
+/**
+ * @brief recordAnimationFrame 记录一帧从 valueChanged 到窗口移动和绘制完成的耗时，不包含帧之间的等待
+ * @param painted 是否由这一帧的绘制完成触发
+ */
+void MultiScreenWorker::recordAnimationFrame(bool painted)
+{
+#ifdef ENABLE_PERF_TIMERS
+    if (!m_frameTimer.isValid())
+        return;
+
+    PerfStatistics::instance()->record("animation", "dockFrame", painted ? m_frameTimer.nsecsElapsed() : m_frameMoveTime);
+    m_frameTimer.invalidate();
+#else
+    Q_UNUSED(painted);
+#endif
+}
+
+/**
+ * @brief onEdgeCursorMove 鼠标到达唤起区域，来自指针屏障或 XEventMonitor
+ * @param pos 设备像素坐标
+ * @param timestamp 事件产生时的单调时钟毫秒数，未知时为 0
+ */
+void MultiScreenWorker::onEdgeCursorMove(const QPoint &pos, qint64 timestamp)
+{
+    if (testState(MousePress) || testState(ChangePositionAnimationStart) || testState(ShowAnimationStart) || testState(HideAnimationStart))
+        return;
+
+    QString toScreen;
+
+    /**
+     * 坐标位于当前屏幕边缘时,当做屏幕内移动处理(防止鼠标移动到边缘时不唤醒任务栏)
+     * 使用screenAt获取屏幕名时,实际上获取的不一定是当前屏幕
+     * 举例:点(100,100)不在(0,0,100,100)的屏幕上
+     */
+    if (onScreenEdge(DOCK_SCREEN->current(), pos))
+        toScreen = DOCK_SCREEN->current();
+    else if (QScreen *screen = DIS_INS->screenAt(pos))
+        toScreen = screen->name();
+
+    if(toScreen.isEmpty()) return;
+
+    // 任务栏显示状态，但需要切换屏幕
+    if (toScreen != DOCK_SCREEN->current()) {
+        if(!m_delayScreen.isEmpty() && m_delayScreen != toScreen) m_delayWakeTimer->stop();
+        if (!m_delayWakeTimer->isActive()) {
+            m_delayScreen = toScreen;
+            m_delayWakeTimer->start();
+        }
+    } else if (m_parent->isHidden()) {
+        m_edgeHitTime = timestamp;
+        displayAnimation(AniAction::Show);
+    }
+}
+
 // 鼠标在任务栏之外移动时,任务栏该响应隐藏时需要隐藏
 void MultiScreenWorker::onExtralRegionMonitorChanged(int x, int y, const QString &key)
 {
@@ -715,32 +833,8 @@ void MultiScreenWorker::checkXEventMonitorService()
         m_extralEventInter = new XEventMonitorInter(serverName, "/org/deepin/dde/XEventMonitor1", QDBusConnection::sessionBus());
 
         connect(m_eventInter, &XEventMonitorInter::CursorMove, this, [this](int x, int y, const QString &key){
-            if (m_registerKey == key && !testState(MousePress) && !testState(ChangePositionAnimationStart) && !testState(ShowAnimationStart) && !testState(HideAnimationStart)) {
-
-                QString toScreen;
-
-                /**
-                 * 坐标位于当前屏幕边缘时,当做屏幕内移动处理(防止鼠标移动到边缘时不唤醒任务栏)
-                 * 使用screenAtByScaled获取屏幕名时,实际上获取的不一定是当前屏幕
-                 * 举例:点(100,100)不在(0,0,100,100)的屏幕上
-                 */
-                if (onScreenEdge(DOCK_SCREEN->current(), QPoint(x, y)))
-                    toScreen = DOCK_SCREEN->current();
-                else if (QScreen *screen = Utils::screenAtByScaled(QPoint(x, y)))
-                    toScreen = screen->name();
-
-                if(toScreen.isEmpty()) return;
-
-                // 任务栏显示状态，但需要切换屏幕
-                if (toScreen != DOCK_SCREEN->current()) {
-                    if(!m_delayScreen.isEmpty() && m_delayScreen != toScreen) m_delayWakeTimer->stop();
-                    if (!m_delayWakeTimer->isActive()) {
-                        m_delayScreen = toScreen;
-                        m_delayWakeTimer->start();
-                    }
-                } else if (m_parent->isHidden())
-                    displayAnimation(AniAction::Show);
-            }
+            if (m_registerKey == key)
+                onEdgeCursorMove(QPoint(x, y), 0);
         });
         connect(m_eventInter, &XEventMonitorInter::ButtonPress, this, [ this ] { setStates(MousePress, true); });
         connect(m_eventInter, &XEventMonitorInter::ButtonRelease, this, [ this ] { setStates(MousePress, false); });
@@ -29,6 +29,9 @@
 #include <DWindowManagerHelper>
 #include <QObject>
 #include <QFlag>
+#include <QElapsedTimer>
+#include <QVariantAnimation>
+#include <QPointer>
 
 DGUI_USE_NAMESPACE
 /**
@@ -40,6 +43,7 @@ DGUI_USE_NAMESPACE
 using namespace Dock;
 class QTimer;
 class MainWindow;
+class EdgeMonitor;
 
 class MultiScreenWorker : public QObject
 {
@@ -110,6 +114,9 @@ private:
     void resetDockScreen();
 
     bool isCursorOut(int x, int y);
+    void onEdgeCursorMove(const QPoint &pos, qint64 timestamp);
+    void onAnimationValueChanged(const QVariant &value);
+    void recordAnimationFrame(bool painted);
     void onExtralRegionMonitorChanged(int x, int y, const QString &key);
     void checkDaemonDockService();
     void checkXEventMonitorService();
@@ -118,15 +125,19 @@ private:
     bool onScreenEdge(const QString &screenName, const QPoint &point);
     const QPoint rawXPosition(const QPoint &scaledPos);
     void updateDockRect(QRect &dockRect, QRect screenRect, Position position, qreal ratio, int dockSize, int count);
-    bool isCopyMode();
 
 private:
     MainWindow *m_parent;
-    QPropertyAnimation *ani;
+    QVariantAnimation *ani;
 
     // monitor screen
     XEventMonitorInter *m_eventInter;
     XEventMonitorInter *m_extralEventInter;
+    EdgeMonitor *m_edgeMonitor;                 // 支持指针屏障时代替 m_eventInter 检测唤起区域
+    qint64 m_edgeHitTime;                       // 触发显示动画的边缘事件时间，用于统计唤起延迟
+    QPointer<QVariantAnimation> m_frameAnimation; // 当前正在运行的动画
+    QElapsedTimer m_frameTimer;                 // 动画当前帧开始的时间
+    qint64 m_frameMoveTime;                     // 当前帧移动窗口的耗时
 
     // DBus interface
     LauncherInter *m_launcherInter;
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "perfstatistics.h"
+
+#include <QCoreApplication>
+#include <QEvent>
+
+#include <cstring>
+
+namespace {
+
+// 小于 4 微秒的值各占一个桶，之后每个 2 的幂区间分成 4 个桶，相对误差不超过 25%
+int bucketIndex(qint64 usecs)
+{
+    if (usecs < 4)
+        return int(qMax<qint64>(usecs, 0));
+
+    const int octave = 63 - __builtin_clzll(quint64(usecs));
+    const int sub = int(usecs >> (octave - 2)) & 3;
+    return qMin(4 + (octave - 2) * 4 + sub, 127);
+}
+
+qint64 bucketUpperBound(int index)
+{
+    if (index < 4)
+        return index;
+
+    const int octave = (index - 4) / 4 + 2;
+    const qint64 lower = qint64(4 + (index - 4) % 4) << (octave - 2);
+    return lower + (qint64(1) << (octave - 2)) - 1;
+}
+
+} // namespace
+
+PerfStatistics *PerfStatistics::instance()
+{
+    static PerfStatistics *statistics = new PerfStatistics;
+    return statistics;
+}
+
+void PerfStatistics::record(const char *category, const char *name, qint64 nsecs)
+{
+    auto it = m_histograms.find(qMakePair(category, name));
+    if (it == m_histograms.end()) {
+        Histogram histogram;
+        std::memset(&histogram, 0, sizeof(histogram));
+        histogram.category = category;
+        histogram.name = name;
+        it = m_histograms.insert(qMakePair(category, name), histogram);
+    }
+
+    const qint64 usecs = nsecs / 1000;
+    it->count++;
+    it->total += usecs;
+    it->max = qMax(it->max, usecs);
+    it->buckets[bucketIndex(usecs)]++;
+}
+
+QVariantMap PerfStatistics::statistics() const
+{
+    // 同名的不同字符串常量在这里合并
+    QHash<QString, Histogram> merged;
+    for (const Histogram &histogram : m_histograms) {
+        const QString key = QString("%1/%2").arg(histogram.category).arg(histogram.name);
+        auto it = merged.find(key);
+        if (it == merged.end()) {
+            merged.insert(key, histogram);
+            continue;
+        }
+
+        it->count += histogram.count;
+        it->total += histogram.total;
+        it->max = qMax(it->max, histogram.max);
+        for (int i = 0; i < 128; ++i)
+            it->buckets[i] += histogram.buckets[i];
+    }
+
+    QVariantMap statistics;
+    for (auto it = merged.constBegin(); it != merged.constEnd(); ++it) {
+        const Histogram &histogram = it.value();
+        const quint64 p50 = (histogram.count + 1) / 2;
+        const quint64 p99 = histogram.count - histogram.count / 100;
+
+        qint64 p50Value = -1, p99Value = -1;
+        quint64 seen = 0;
+        for (int i = 0; i < 128 && p99Value < 0; ++i) {
+            seen += histogram.buckets[i];
+            if (p50Value < 0 && seen >= p50)
+                p50Value = qMin(bucketUpperBound(i), histogram.max);
+            if (seen >= p99)
+                p99Value = qMin(bucketUpperBound(i), histogram.max);
+        }
+
+        QVariantMap entry;
+        entry["count"] = histogram.count;
+        entry["p50"] = p50Value;
+        entry["p99"] = p99Value;
+        entry["max"] = histogram.max;
+        entry["average"] = histogram.count ? histogram.total / qint64(histogram.count) : 0;
+        statistics.insert(it.key(), entry);
+    }
+
+    return statistics;
+}
+
+void PerfStatistics::reset()
+{
+    m_histograms.clear();
+}
+
+PerfLayoutProbe::PerfLayoutProbe(QObject *widget, const char *name)
+    : QObject(widget)
+    , m_widget(widget)
+    , m_name(name)
+    , m_armed(false)
+{
+}
+
+/**
+ * @brief PerfLayoutProbe::arm 控件即将收到 LayoutRequest 时调用，安装应用级事件过滤器
+ */
+void PerfLayoutProbe::arm()
+{
+    if (m_armed)
+        return;
+
+    m_armed = true;
+    qApp->installEventFilter(this);
+}
+
+void PerfLayoutProbe::finish()
+{
+    if (m_armed) {
+        qApp->removeEventFilter(this);
+        m_armed = false;
+    }
+
+    if (!m_timer.isValid())
+        return;
+
+    PerfStatistics::instance()->record("layout", m_name, m_timer.nsecsElapsed());
+    m_timer.invalidate();
+}
+
+bool PerfLayoutProbe::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_widget && event->type() == QEvent::LayoutRequest)
+        m_timer.start();
+
+    return false;
+}
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef PERFSTATISTICS_H
+#define PERFSTATISTICS_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QVariantMap>
+
+/**
+ * @brief The PerfStatistics class
+ * 绘制、布局、尺寸调整和动画帧的耗时统计，按 "类别/类名" 汇总成对数分桶直方图，
+ * 通过 DBus 读取 count、p50、p99、max（微秒）。只在界面线程中记录。
+ */
+class PerfStatistics
+{
+public:
+    static PerfStatistics *instance();
+
+    void record(const char *category, const char *name, qint64 nsecs);
+    QVariantMap statistics() const;
+    void reset();
+
+private:
+    PerfStatistics() = default;
+
+    struct Histogram {
+        const char *category;
+        const char *name;
+        quint64 count;
+        qint64 max;         // 微秒
+        qint64 total;
+        quint32 buckets[128];
+    };
+
+    // 类别和类名都是字符串常量或 metaObject()->className()，按地址查找即可
+    QHash<QPair<const char *, const char *>, Histogram> m_histograms;
+};
+
+class PerfScope
+{
+public:
+    PerfScope(const char *category, const char *name) : m_category(category), m_name(name) { m_timer.start(); }
+    ~PerfScope() { PerfStatistics::instance()->record(m_category, m_name, m_timer.nsecsElapsed()); }
+
+private:
+    const char *m_category;
+    const char *m_name;
+    QElapsedTimer m_timer;
+};
+
+/**
+ * @brief The PerfLayoutProbe class
+ * QApplication 在调用控件 event() 之前已经由 QLayout::widgetEvent() 完成布局，控件内部计不到时间。
+ * 这里用应用级事件过滤器在布局之前开始计时，控件处理 LayoutRequest 时调用 finish() 记录到 "layout/name"。
+ * 过滤器只在 arm() 之后到下一次 finish() 之间安装，其余时间应用的事件不经过这里
+ */
+class PerfLayoutProbe : public QObject
+{
+public:
+    PerfLayoutProbe(QObject *widget, const char *name);
+
+    void arm();
+    void finish();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    QObject *m_widget;
+    const char *m_name;
+    QElapsedTimer m_timer;
+    bool m_armed;
+};
+
+// 编译时关闭 ENABLE_PERF_TIMERS 后不产生任何代码
+#ifdef ENABLE_PERF_TIMERS
+#define PERF_SCOPE_CONCAT_(a, b) a##b
+#define PERF_SCOPE_CONCAT(a, b) PERF_SCOPE_CONCAT_(a, b)
+#define PERF_SCOPE(category, name) PerfScope PERF_SCOPE_CONCAT(perfScope, __LINE__)(category, name)
+#else
+#define PERF_SCOPE(category, name) do {} while (0)
+#endif
+
+#endif // PERFSTATISTICS_H
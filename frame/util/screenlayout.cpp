@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "screenlayout.h"
+
+#include <algorithm>
+
+using namespace Dock;
+
+constexpr quint8 ScreenLayout::AllEdges;
+
+void ScreenLayout::setRects(const QVector<QRect> &rects)
+{
+    m_edges = dockableEdges(rects);
+
+    m_copyMode = rects.size() > 1;
+    for (const QRect &rect : rects)
+        m_copyMode &= rect.topLeft() == rects.first().topLeft();
+
+    m_columns.clear();
+    m_rows.clear();
+    for (const QRect &rect : rects) {
+        m_columns << rect.x() << rect.x() + rect.width();
+        m_rows << rect.y() << rect.y() + rect.height();
+    }
+    std::sort(m_columns.begin(), m_columns.end());
+    m_columns.erase(std::unique(m_columns.begin(), m_columns.end()), m_columns.end());
+    std::sort(m_rows.begin(), m_rows.end());
+    m_rows.erase(std::unique(m_rows.begin(), m_rows.end()), m_rows.end());
+
+    // 网格线包含了所有屏幕的边，一个格子要么整个在某块屏幕内，要么完全不在
+    const int columnCount = qMax(m_columns.size() - 1, 0);
+    const int rowCount = qMax(m_rows.size() - 1, 0);
+    m_cells.fill(-1, columnCount * rowCount);
+    for (int row = 0; row < rowCount; ++row) {
+        for (int column = 0; column < columnCount; ++column) {
+            const QPoint corner(m_columns.at(column), m_rows.at(row));
+            for (int i = 0; i < rects.size(); ++i) {
+                if (rects.at(i).contains(corner)) {
+                    m_cells[row * columnCount + column] = i;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief ScreenLayout::indexAt
+ * @return 包含 point 的屏幕序号，重叠时取靠前的屏幕，不在任何屏幕上时返回 -1
+ */
+int ScreenLayout::indexAt(const QPoint &point) const
+{
+    const int column = int(std::upper_bound(m_columns.begin(), m_columns.end(), point.x()) - m_columns.begin()) - 1;
+    const int row = int(std::upper_bound(m_rows.begin(), m_rows.end(), point.y()) - m_rows.begin()) - 1;
+    const int columnCount = m_columns.size() - 1;
+    if (column < 0 || column >= columnCount || row < 0 || row >= m_rows.size() - 1)
+        return -1;
+
+    return m_cells.at(row * columnCount + column);
+}
+
+/**
+ * @brief ScreenLayout::dockableEdges
+ * 根据各屏幕区域计算可停靠的边：和另一块屏幕共用一段边（重叠长度大于0）时，两边都不可停靠，
+ * 只有角相接的对角拼接和完全重叠的复制模式不影响停靠，屏幕数量和排列方式不限
+ */
+QVector<quint8> ScreenLayout::dockableEdges(const QVector<QRect> &rects)
+{
+    QVector<quint8> edges(rects.size(), AllEdges);
+
+    for (int i = 0; i < rects.size(); ++i) {
+        for (int j = i + 1; j < rects.size(); ++j) {
+            const QRect &a = rects.at(i);
+            const QRect &b = rects.at(j);
+
+            const int hOverlap = qMin(a.x() + a.width(), b.x() + b.width()) - qMax(a.x(), b.x());
+            const int vOverlap = qMin(a.y() + a.height(), b.y() + b.height()) - qMax(a.y(), b.y());
+
+            // 左右拼接
+            if (vOverlap > 0) {
+                if (a.x() + a.width() == b.x()) {
+                    edges[i] &= ~(1 << Right);
+                    edges[j] &= ~(1 << Left);
+                } else if (b.x() + b.width() == a.x()) {
+                    edges[i] &= ~(1 << Left);
+                    edges[j] &= ~(1 << Right);
+                }
+            }
+
+            // 上下拼接
+            if (hOverlap > 0) {
+                if (a.y() + a.height() == b.y()) {
+                    edges[i] &= ~(1 << Bottom);
+                    edges[j] &= ~(1 << Top);
+                } else if (b.y() + b.height() == a.y()) {
+                    edges[i] &= ~(1 << Top);
+                    edges[j] &= ~(1 << Bottom);
+                }
+            }
+        }
+    }
+
+    return edges;
+}
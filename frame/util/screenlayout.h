@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SCREENLAYOUT_H
+#define SCREENLAYOUT_H
+
+#include "interfaces/constants.h"
+
+#include <QPoint>
+#include <QRect>
+#include <QVector>
+
+/**
+ * @brief The ScreenLayout class
+ * 只依赖屏幕区域的多屏计算，供 DisplayManager 在屏幕信息变化时调用一次。
+ * 所有区域的位置为原始坐标，大小已乘以缩放（设备像素）
+ */
+class ScreenLayout
+{
+public:
+    static constexpr quint8 AllEdges = (1 << Dock::Top) | (1 << Dock::Right) | (1 << Dock::Bottom) | (1 << Dock::Left);
+
+    void setRects(const QVector<QRect> &rects);
+
+    // 与 rects 一一对应，按位存放 1 << Position
+    const QVector<quint8> &dockableEdges() const { return m_edges; }
+    bool isCopyMode() const { return m_copyMode; }
+    int indexAt(const QPoint &point) const;
+
+    static QVector<quint8> dockableEdges(const QVector<QRect> &rects);
+
+private:
+    QVector<quint8> m_edges;
+    bool m_copyMode = false;
+
+    // 按所有屏幕的边界把平面切成网格，每格记录覆盖它的第一块屏幕的序号（-1 为空），查找只需两次二分
+    QVector<int> m_columns;
+    QVector<int> m_rows;
+    QVector<int> m_cells;
+};
+
+#endif // SCREENLAYOUT_H
@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "settingswriter.h"
+
+#include <QSettings>
+#include <QTextCodec>
+
+SettingsWriter::SettingsWriter(const QString &fileName, QObject *parent)
+    : QObject(parent)
+    , m_fileName(fileName)
+    , m_settings(nullptr)
+{
+}
+
+void SettingsWriter::write(const QVariantMap &values)
+{
+    if (!m_settings) {
+        m_settings = new QSettings(m_fileName, QSettings::IniFormat, this);
+        m_settings->setIniCodec(QTextCodec::codecForName("UTF-8"));
+    }
+
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it)
+        m_settings->setValue(it.key(), it.value());
+    m_settings->sync();
+
+    emit written(values);
+}
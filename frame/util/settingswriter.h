@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SETTINGSWRITER_H
+#define SETTINGSWRITER_H
+
+#include <QObject>
+#include <QVariantMap>
+
+class QSettings;
+
+/**
+ * @brief The SettingsWriter class
+ * 运行在独立线程中，把界面线程合并后的设置修改写入 ini 文件，避免在界面线程同步写盘
+ */
+class SettingsWriter : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SettingsWriter(const QString &fileName, QObject *parent = nullptr);
+
+public slots:
+    void write(const QVariantMap &values);
+
+signals:
+    void written(const QVariantMap &values) const;
+
+private:
+    const QString m_fileName;
+    QSettings *m_settings;      // 在写入线程中创建
+};
+
+#endif // SETTINGSWRITER_H
@@ -0,0 +1,284 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "snapshotcapturer.h"
+#include "thumbnailscaler.h"
+
+#include <QThread>
+#include <QCoreApplication>
+#include <QDebug>
+
+#include <X11/Xlib.h>
+#include <X11/X.h>
+#include <X11/Xutil.h>
+#include <X11/Xatom.h>
+#include <sys/shm.h>
+
+#define MAX_PENDING_REQUESTS 64
+
+struct SHMInfo {
+    long shmid;
+    long width;
+    long height;
+    long bytesPerLine;
+    long format;
+
+    struct Rect {
+        long x;
+        long y;
+        long width;
+        long height;
+    } rect;
+};
+
+SnapshotWorker::SnapshotWorker(QObject *parent)
+    : QObject(parent)
+    , m_display(XOpenDisplay(nullptr))
+    , m_scheduled(false)
+    , m_captureCount(0)
+    , m_capturedBytes(0)
+{
+    if (!m_display)
+        qWarning() << "open X display for snapshot failed!";
+}
+
+SnapshotWorker::~SnapshotWorker()
+{
+    if (m_display)
+        XCloseDisplay(m_display);
+}
+
+bool SnapshotWorker::enqueue(const SnapshotRequest &request)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_pending.find(request.wid);
+    if (it != m_pending.end()) {
+        // 同一窗口只保留一个请求，合并需要的尺寸并取较高的优先级
+        for (const SnapshotTarget &target : request.targets)
+            if (!it->targets.contains(target))
+                it->targets.append(target);
+        it->priority = qMax(it->priority, request.priority);
+    } else {
+        if (m_pending.size() >= MAX_PENDING_REQUESTS) {
+            // 队列已满，丢弃优先级最低且最早的请求
+            auto victim = m_pending.begin();
+            for (auto i = m_pending.begin(); i != m_pending.end(); ++i)
+                if (i->priority < victim->priority || (i->priority == victim->priority && i->serial < victim->serial))
+                    victim = i;
+
+            if (victim->priority > request.priority)
+                return false;
+
+            m_pending.erase(victim);
+        }
+        m_pending.insert(request.wid, request);
+    }
+
+    if (!m_scheduled) {
+        m_scheduled = true;
+        QMetaObject::invokeMethod(this, "process", Qt::QueuedConnection);
+    }
+
+    return true;
+}
+
+void SnapshotWorker::cancel(const WId wid)
+{
+    QMutexLocker locker(&m_mutex);
+    m_pending.remove(wid);
+}
+
+void SnapshotWorker::process()
+{
+    SnapshotRequest request;
+    while (takeNext(request)) {
+        if (!capture(request))
+            emit failed(request.wid);
+    }
+}
+
+bool SnapshotWorker::takeNext(SnapshotRequest &request)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_pending.isEmpty()) {
+        m_scheduled = false;
+        return false;
+    }
+
+    auto next = m_pending.begin();
+    for (auto i = m_pending.begin(); i != m_pending.end(); ++i)
+        if (i->priority > next->priority || (i->priority == next->priority && i->serial < next->serial))
+            next = i;
+
+    request = next.value();
+    m_pending.erase(next);
+    return true;
+}
+
+bool SnapshotWorker::capture(const SnapshotRequest &request)
+{
+    if (!m_display)
+        return false;
+
+    QImage source;
+    QRect sourceRect;
+    SHMInfo *info = nullptr;
+    uchar *image_data = nullptr;
+    XImage *ximage = nullptr;
+
+    // get window image from shm(only for deepin app)
+    Atom atom_prop = XInternAtom(m_display, "_DEEPIN_DXCB_SHM_INFO", true);
+    if (atom_prop) {
+        Atom actual_type_return_deepin_shm;
+        int actual_format_return_deepin_shm;
+        unsigned long nitems_return_deepin_shm;
+        unsigned long bytes_after_return_deepin_shm;
+        unsigned char *prop_return_deepin_shm = nullptr;
+
+        XGetWindowProperty(m_display, request.wid, atom_prop, 0, 32 * 9, false, AnyPropertyType,
+                           &actual_type_return_deepin_shm, &actual_format_return_deepin_shm, &nitems_return_deepin_shm,
+                           &bytes_after_return_deepin_shm, &prop_return_deepin_shm);
+        info = reinterpret_cast<SHMInfo *>(prop_return_deepin_shm);
+    }
+
+    if (info) {
+        image_data = (uchar *)shmat(info->shmid, 0, 0);
+        if ((qint64)image_data != -1) {
+            source = QImage(image_data, info->width, info->height, info->bytesPerLine, (QImage::Format)info->format);
+            sourceRect = QRect(info->rect.x, info->rect.y, info->rect.width, info->rect.height);
+        } else {
+            qDebug() << "invalid pointer of shm!";
+            image_data = nullptr;
+        }
+    }
+
+    if (source.isNull()) {
+        // get window image from XGetImage(a little slow)
+        Window unused_window;
+        int unused_int;
+        unsigned unused_uint, w, h;
+        if (XGetGeometry(m_display, request.wid, &unused_window, &unused_int, &unused_int, &w, &h, &unused_uint, &unused_uint))
+            ximage = XGetImage(m_display, request.wid, 0, 0, w, h, AllPlanes, ZPixmap);
+
+        if (ximage) {
+            source = QImage((const uchar *)(ximage->data), ximage->width, ximage->height, ximage->bytes_per_line, QImage::Format_RGB32);
+            // remove shadow frame
+            sourceRect = rectRemovedShadow(request.wid, source.size());
+        }
+    }
+
+    if (!source.isNull()) {
+        m_captureCount.fetchAndAddRelaxed(1);
+        m_capturedBytes.fetchAndAddRelaxed(quint64(sourceRect.width()) * sourceRect.height() * 4);
+    }
+
+    bool success = false;
+    for (const SnapshotTarget &target : request.targets) {
+        if (source.isNull())
+            break;
+
+        QImage image;
+        ThumbnailScaler::scale(source, sourceRect, sourceRect.size().scaled(target.size, Qt::KeepAspectRatio), image);
+        if (image.isNull())
+            continue;
+
+        image.setDevicePixelRatio(target.ratio);
+        emit captured(request.wid, target.size, image);
+        success = true;
+    }
+
+    if (image_data) shmdt(image_data);
+    if (ximage) XDestroyImage(ximage);
+    if (info) XFree(info);
+
+    return success;
+}
+
+QRect SnapshotWorker::rectRemovedShadow(const WId wid, const QSize &size)
+{
+    QRect rect(QPoint(0, 0), size);
+
+    const Atom gtk_frame_extents = XInternAtom(m_display, "_GTK_FRAME_EXTENTS", true);
+    if (!gtk_frame_extents)
+        return rect;
+
+    Atom actual_type_return_gtk;
+    int actual_format_return_gtk;
+    unsigned long n_items_return_gtk;
+    unsigned long bytes_after_return_gtk;
+    unsigned char *prop_to_return_gtk = nullptr;
+
+    const auto r = XGetWindowProperty(m_display, wid, gtk_frame_extents, 0, 4, false, XA_CARDINAL,
+                                      &actual_type_return_gtk, &actual_format_return_gtk, &n_items_return_gtk, &bytes_after_return_gtk, &prop_to_return_gtk);
+    if (!r && prop_to_return_gtk && n_items_return_gtk == 4 && actual_format_return_gtk == 32) {
+        const unsigned long *extents = reinterpret_cast<const unsigned long *>(prop_to_return_gtk);
+        const int left = extents[0];
+        const int right = extents[1];
+        const int top = extents[2];
+        const int bottom = extents[3];
+
+        rect = QRect(left, top, size.width() - left - right, size.height() - top - bottom);
+    }
+
+    if (prop_to_return_gtk) XFree(prop_to_return_gtk);
+
+    return rect;
+}
+
+SnapshotCapturer *SnapshotCapturer::instance()
+{
+    static SnapshotCapturer *capturer = new SnapshotCapturer;
+    return capturer;
+}
+
+SnapshotCapturer::SnapshotCapturer() : QObject()
+    , m_thread(new QThread(this))
+    , m_worker(new SnapshotWorker)
+    , m_serial(0)
+{
+    qRegisterMetaType<WId>("WId");
+    qRegisterMetaType<QSize>("QSize");
+
+    m_worker->moveToThread(m_thread);
+
+    connect(m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &SnapshotWorker::captured, this, &SnapshotCapturer::snapshotReady, Qt::QueuedConnection);
+    connect(m_worker, &SnapshotWorker::failed, this, &SnapshotCapturer::snapshotFailed, Qt::QueuedConnection);
+    connect(qApp, &QCoreApplication::aboutToQuit, m_thread, [this] {
+        m_thread->quit();
+        m_thread->wait();
+    });
+
+    m_thread->setObjectName("SnapshotCapturer");
+    m_thread->start(QThread::LowPriority);
+}
+
+SnapshotCapturer::~SnapshotCapturer()
+{
+    m_thread->quit();
+    m_thread->wait();
+}
+
+void SnapshotCapturer::request(const WId wid, const QSize &size, const qreal ratio, const Priority priority)
+{
+    if (!wid || size.isEmpty())
+        return;
+
+    m_worker->enqueue(SnapshotRequest { wid, { SnapshotTarget { size, ratio } }, priority, ++m_serial });
+}
+
+void SnapshotCapturer::cancel(const WId wid)
+{
+    m_worker->cancel(wid);
+}
+
+quint64 SnapshotCapturer::captureCount() const
+{
+    return m_worker->captureCount();
+}
+
+quint64 SnapshotCapturer::capturedBytes() const
+{
+    return m_worker->capturedBytes();
+}
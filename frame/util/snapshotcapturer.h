@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef SNAPSHOTCAPTURER_H
+#define SNAPSHOTCAPTURER_H
+
+#include <QObject>
+#include <QImage>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <QAtomicInteger>
+#include <QVariantMap>
+#include <QWidget>
+
+class QThread;
+struct _XDisplay;
+typedef _XDisplay Display;
+
+struct SnapshotTarget
+{
+    QSize size;         // 预览图的最大尺寸，单位为设备像素，按窗口比例缩放到其中
+    qreal ratio;
+
+    bool operator==(const SnapshotTarget &other) const { return size == other.size && qFuzzyCompare(ratio, other.ratio); }
+};
+
+struct SnapshotRequest
+{
+    WId wid;
+    QVector<SnapshotTarget> targets;    // 同一窗口只截一次图，再缩放成所有需要的尺寸
+    int priority;
+    quint64 serial;
+};
+
+/**
+ * @brief The SnapshotWorker class
+ * 运行在截图线程中，使用独立的X连接截取窗口并缩放，同一窗口的请求会被合并
+ */
+class SnapshotWorker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SnapshotWorker(QObject *parent = nullptr);
+    ~SnapshotWorker();
+
+    bool enqueue(const SnapshotRequest &request);
+    void cancel(const WId wid);
+
+    quint64 captureCount() const { return m_captureCount.loadAcquire(); }
+    quint64 capturedBytes() const { return m_capturedBytes.loadAcquire(); }
+
+public slots:
+    void process();
+
+signals:
+    void captured(const WId wid, const QSize &size, const QImage &image) const;
+    void failed(const WId wid) const;
+
+private:
+    bool takeNext(SnapshotRequest &request);
+    bool capture(const SnapshotRequest &request);
+    QRect rectRemovedShadow(const WId wid, const QSize &size);
+
+private:
+    Display *m_display;
+    QMutex m_mutex;
+    QHash<WId, SnapshotRequest> m_pending;
+    bool m_scheduled;
+
+    QAtomicInteger<quint64> m_captureCount;
+    QAtomicInteger<quint64> m_capturedBytes;    // 从X读取的窗口像素字节数
+};
+
+/**
+ * @brief The SnapshotCapturer class
+ * 窗口预览图的截图入口，请求按优先级在截图线程中处理，结果通过队列信号回到界面线程
+ */
+class SnapshotCapturer : public QObject
+{
+    Q_OBJECT
+public:
+    enum Priority {
+        Background = 0,     // 定时刷新
+        Visible = 1         // 正在显示的预览
+    };
+
+    static SnapshotCapturer *instance();
+
+    void request(const WId wid, const QSize &size, const qreal ratio, const Priority priority);
+    void cancel(const WId wid);
+
+    quint64 captureCount() const;
+    quint64 capturedBytes() const;
+
+signals:
+    void snapshotReady(const WId wid, const QSize &size, const QImage &image) const;
+    void snapshotFailed(const WId wid) const;
+
+private:
+    explicit SnapshotCapturer();
+    ~SnapshotCapturer();
+
+private:
+    QThread *m_thread;
+    SnapshotWorker *m_worker;
+    quint64 m_serial;
+};
+
+#endif // SNAPSHOTCAPTURER_H
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "thumbnailcache.h"
+
+#define DEFAULT_MEMORY_LIMIT (64 * 1024 * 1024)
+// 在这个时间内再次请求同一缩略图时直接使用缓存，不再截图
+#define FRESH_INTERVAL 1000
+
+static ThumbnailKey makeKey(const WId wid, const QSize &size, const qreal ratio)
+{
+    return ThumbnailKey { wid, size, qRound(ratio * 100) };
+}
+
+ThumbnailCache *ThumbnailCache::instance()
+{
+    static ThumbnailCache *cache = new ThumbnailCache;
+    return cache;
+}
+
+ThumbnailCache::ThumbnailCache() : QObject()
+    , m_cache(DEFAULT_MEMORY_LIMIT)
+    , m_hits(0)
+    , m_misses(0)
+{
+    connect(SnapshotCapturer::instance(), &SnapshotCapturer::snapshotReady, this, &ThumbnailCache::onSnapshotReady);
+    connect(SnapshotCapturer::instance(), &SnapshotCapturer::snapshotFailed, this, &ThumbnailCache::onSnapshotFailed);
+}
+
+/**
+ * @brief ThumbnailCache::thumbnail 返回缓存的缩略图，没有缓存或已过期时请求重新截图，
+ * 新的截图通过 thumbnailChanged 信号送达
+ */
+QImage ThumbnailCache::thumbnail(const WId wid, const QSize &size, const qreal ratio, const SnapshotCapturer::Priority priority)
+{
+    if (!wid || size.isEmpty())
+        return QImage();
+
+    const Entry *entry = m_cache.object(makeKey(wid, size, ratio));
+    if (entry && entry->timer.elapsed() < FRESH_INTERVAL) {
+        ++m_hits;
+        return entry->image;
+    }
+
+    ++m_misses;
+    SnapshotCapturer::instance()->request(wid, size, ratio, priority);
+
+    return entry ? entry->image : QImage();
+}
+
+void ThumbnailCache::remove(const WId wid)
+{
+    SnapshotCapturer::instance()->cancel(wid);
+
+    for (const ThumbnailKey &key : m_cache.keys())
+        if (key.wid == wid)
+            m_cache.remove(key);
+}
+
+void ThumbnailCache::setMemoryLimit(const int bytes)
+{
+    m_cache.setMaxCost(qMax(0, bytes));
+}
+
+int ThumbnailCache::memoryLimit() const
+{
+    return m_cache.maxCost();
+}
+
+int ThumbnailCache::memoryUsage() const
+{
+    return m_cache.totalCost();
+}
+
+QVariantMap ThumbnailCache::statistics() const
+{
+    QVariantMap result;
+    result.insert("count", m_cache.count());
+    result.insert("memoryUsage", memoryUsage());
+    result.insert("memoryLimit", memoryLimit());
+    result.insert("hits", m_hits);
+    result.insert("misses", m_misses);
+    return result;
+}
+
+void ThumbnailCache::onSnapshotReady(const WId wid, const QSize &size, const QImage &image)
+{
+    const ThumbnailKey key = makeKey(wid, size, image.devicePixelRatio());
+
+    // 内容没有变化时保留原来的图片，不触发界面重绘
+    Entry *old = m_cache.object(key);
+    if (old && old->image == image) {
+        old->timer.start();
+        emit thumbnailUnchanged(wid, size);
+        return;
+    }
+
+    Entry *entry = new Entry { image, QElapsedTimer() };
+    entry->timer.start();
+
+    // 单张图片超过整个预算时 QCache 会直接丢弃，界面仍然可以使用信号里的图片
+    m_cache.insert(key, entry, int(image.sizeInBytes()));
+
+    emit thumbnailChanged(wid, size, image);
+}
+
+void ThumbnailCache::onSnapshotFailed(const WId wid)
+{
+    remove(wid);
+
+    emit thumbnailFailed(wid);
+}
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef THUMBNAILCACHE_H
+#define THUMBNAILCACHE_H
+
+#include "snapshotcapturer.h"
+
+#include <QObject>
+#include <QCache>
+#include <QElapsedTimer>
+#include <QVariantMap>
+
+struct ThumbnailKey
+{
+    WId wid;
+    QSize size;
+    int ratio;          // 缩放比例 * 100，避免浮点数作为键
+
+    bool operator==(const ThumbnailKey &other) const { return wid == other.wid && size == other.size && ratio == other.ratio; }
+};
+
+inline uint qHash(const ThumbnailKey &key, uint seed = 0)
+{
+    return qHash(quint64(key.wid), seed) ^ qHash(key.size.width() << 16 | key.size.height(), seed) ^ uint(key.ratio);
+}
+
+/**
+ * @brief The ThumbnailCache class
+ * 任务栏窗口项、预览弹窗和悬浮预览共用的窗口缩略图缓存，按 (窗口, 尺寸, 缩放比例) 索引，
+ * 图片以隐式共享的 QImage 交给界面使用。缓存按占用内存做 LRU 淘汰，窗口销毁或截图失败时移除。
+ */
+class ThumbnailCache : public QObject
+{
+    Q_OBJECT
+public:
+    static ThumbnailCache *instance();
+
+    QImage thumbnail(const WId wid, const QSize &size, const qreal ratio, const SnapshotCapturer::Priority priority);
+    void remove(const WId wid);
+
+    void setMemoryLimit(const int bytes);
+    int memoryLimit() const;
+    int memoryUsage() const;
+    QVariantMap statistics() const;
+
+signals:
+    void thumbnailChanged(const WId wid, const QSize &size, const QImage &image) const;
+    void thumbnailUnchanged(const WId wid, const QSize &size) const;
+    void thumbnailFailed(const WId wid) const;
+
+private:
+    explicit ThumbnailCache();
+
+    void onSnapshotReady(const WId wid, const QSize &size, const QImage &image);
+    void onSnapshotFailed(const WId wid);
+
+private:
+    struct Entry {
+        QImage image;
+        QElapsedTimer timer;
+    };
+
+    QCache<ThumbnailKey, Entry> m_cache;
+    quint64 m_hits;
+    quint64 m_misses;
+};
+
+#endif // THUMBNAILCACHE_H
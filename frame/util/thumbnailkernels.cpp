@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "thumbnailkernels.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace ThumbnailKernels {
+
+namespace {
+
+// 每个通道 (a + b + c + d + 2) / 4，一次处理两个通道
+inline uint32_t average4(uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+{
+    const uint32_t mask = 0x00ff00ff;
+    const uint32_t lo = ((a & mask) + (b & mask) + (c & mask) + (d & mask) + 0x00020002) >> 2;
+    const uint32_t hi = (((a >> 8) & mask) + ((b >> 8) & mask) + ((c >> 8) & mask) + ((d >> 8) & mask) + 0x00020002) >> 2;
+    return (lo & mask) | ((hi & mask) << 8);
+}
+
+} // namespace
+
+void halveRowScalar(const uint32_t *r0, const uint32_t *r1, uint32_t *out, int x, int count)
+{
+    for (; x < count; ++x)
+        out[x] = average4(r0[2 * x], r0[2 * x + 1], r1[2 * x], r1[2 * x + 1]);
+}
+
+#if defined(__SSE2__)
+namespace {
+
+// 4 个像素扩展成 16 位后纵向相加，返回 [p0 p1] 和 [p2 p3] 两组通道和
+inline void verticalSum(__m128i a, __m128i b, __m128i &lo, __m128i &hi)
+{
+    const __m128i zero = _mm_setzero_si128();
+    lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+    hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+}
+
+// 相邻像素横向相加后 (sum + 2) >> 2，得到 2 个输出像素的 16 位通道值
+inline __m128i horizontalAverage(__m128i lo, __m128i hi)
+{
+    const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+    return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+}
+
+} // namespace
+
+void halveRowSSE2(const uint32_t *r0, const uint32_t *r1, uint32_t *out, int x, int count)
+{
+    for (; x + 4 <= count; x += 4) {
+        const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(r0 + 2 * x));
+        const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(r0 + 2 * x + 4));
+        const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(r1 + 2 * x));
+        const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(r1 + 2 * x + 4));
+
+        __m128i s0, s1, s2, s3;
+        verticalSum(a0, b0, s0, s1);
+        verticalSum(a1, b1, s2, s3);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), _mm_packus_epi16(horizontalAverage(s0, s1), horizontalAverage(s2, s3)));
+    }
+
+    halveRowScalar(r0, r1, out, x, count);
+}
+
+__attribute__((target("avx2")))
+void halveRowAVX2(const uint32_t *r0, const uint32_t *r1, uint32_t *out, int x, int count)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i two = _mm256_set1_epi16(2);
+
+    for (; x + 8 <= count; x += 8) {
+        const __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(r0 + 2 * x));
+        const __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(r0 + 2 * x + 8));
+        const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(r1 + 2 * x));
+        const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(r1 + 2 * x + 8));
+
+        // unpack 和 pack 都在 128 位通道内进行，每个通道的处理方式与 SSE2 相同
+        const __m256i s0 = _mm256_add_epi16(_mm256_unpacklo_epi8(a0, zero), _mm256_unpacklo_epi8(b0, zero));
+        const __m256i s1 = _mm256_add_epi16(_mm256_unpackhi_epi8(a0, zero), _mm256_unpackhi_epi8(b0, zero));
+        const __m256i s2 = _mm256_add_epi16(_mm256_unpacklo_epi8(a1, zero), _mm256_unpacklo_epi8(b1, zero));
+        const __m256i s3 = _mm256_add_epi16(_mm256_unpackhi_epi8(a1, zero), _mm256_unpackhi_epi8(b1, zero));
+
+        const __m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi64(s0, s1), _mm256_unpackhi_epi64(s0, s1));
+        const __m256i hi = _mm256_add_epi16(_mm256_unpacklo_epi64(s2, s3), _mm256_unpackhi_epi64(s2, s3));
+        const __m256i packed = _mm256_packus_epi16(_mm256_srli_epi16(_mm256_add_epi16(lo, two), 2),
+                                                   _mm256_srli_epi16(_mm256_add_epi16(hi, two), 2));
+
+        // 结果按 64 位排列为 01 45 23 67，重新排序
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+    halveRowSSE2(r0, r1, out, x, count);
+}
+
+bool hasAVX2()
+{
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+void halveRowNEON(const uint32_t *r0, const uint32_t *r1, uint32_t *out, int x, int count)
+{
+    for (; x + 4 <= count; x += 4) {
+        // vld2 直接把偶数和奇数像素分到两个寄存器
+        const uint32x4x2_t a = vld2q_u32(r0 + 2 * x);
+        const uint32x4x2_t b = vld2q_u32(r1 + 2 * x);
+        const uint8x16_t ae = vreinterpretq_u8_u32(a.val[0]);
+        const uint8x16_t ao = vreinterpretq_u8_u32(a.val[1]);
+        const uint8x16_t be = vreinterpretq_u8_u32(b.val[0]);
+        const uint8x16_t bo = vreinterpretq_u8_u32(b.val[1]);
+
+        // 扩展到 16 位求和，vrshrn 完成 (sum + 2) >> 2 并收窄
+        uint16x8_t lo = vaddl_u8(vget_low_u8(ae), vget_low_u8(ao));
+        lo = vaddw_u8(lo, vget_low_u8(be));
+        lo = vaddw_u8(lo, vget_low_u8(bo));
+        uint16x8_t hi = vaddl_u8(vget_high_u8(ae), vget_high_u8(ao));
+        hi = vaddw_u8(hi, vget_high_u8(be));
+        hi = vaddw_u8(hi, vget_high_u8(bo));
+
+        vst1q_u32(out + x, vreinterpretq_u32_u8(vcombine_u8(vrshrn_n_u16(lo, 2), vrshrn_n_u16(hi, 2))));
+    }
+
+    halveRowScalar(r0, r1, out, x, count);
+}
+#endif
+
+HalveRowFunc halveRow()
+{
+#if defined(__SSE2__)
+    return hasAVX2() ? halveRowAVX2 : halveRowSSE2;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return halveRowNEON;
+#else
+    return halveRowScalar;
+#endif
+}
+
+} // namespace ThumbnailKernels
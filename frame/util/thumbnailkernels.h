@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef THUMBNAILKERNELS_H
+#define THUMBNAILKERNELS_H
+
+#include <cstdint>
+
+/**
+ * 窗口预览图 2x2 box 滤波的行处理函数，不依赖 Qt。
+ * out[i] 为 r0、r1 两行第 2i、2i+1 个像素逐通道的 (a + b + c + d + 2) / 4，从下标 x 处理到 count，
+ * 各 SIMD 实现先扩展到 16 位求和再移位，与标量实现逐字节相同
+ */
+namespace ThumbnailKernels {
+
+typedef void (*HalveRowFunc)(const uint32_t *r0, const uint32_t *r1, uint32_t *out, int x, int count);
+
+void halveRowScalar(const uint32_t *r0, const uint32_t *r1, uint32_t *out, int x, int count);
+
+#if defined(__SSE2__)
+void halveRowSSE2(const uint32_t *r0, const uint32_t *r1, uint32_t *out, int x, int count);
+void halveRowAVX2(const uint32_t *r0, const uint32_t *r1, uint32_t *out, int x, int count);
+bool hasAVX2();
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+void halveRowNEON(const uint32_t *r0, const uint32_t *r1, uint32_t *out, int x, int count);
+#endif
+
+// 当前 CPU 上最快的实现
+HalveRowFunc halveRow();
+
+} // namespace ThumbnailKernels
+
+#endif // THUMBNAILKERNELS_H
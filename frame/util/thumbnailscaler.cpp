@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "thumbnailscaler.h"
+#include "thumbnailkernels.h"
+
+#include <vector>
+
+namespace {
+
+struct Plane {
+    const quint32 *bits;
+    int width;
+    int height;
+    int stride;     // in pixels
+};
+
+Plane halve(const Plane &in, std::vector<quint32> &buffer)
+{
+    const ThumbnailKernels::HalveRowFunc halveRow = ThumbnailKernels::halveRow();
+    const int width = in.width / 2;
+    const int height = in.height / 2;
+
+    buffer.resize(size_t(width) * height);
+    for (int y = 0; y < height; ++y) {
+        const quint32 *r0 = in.bits + size_t(2 * y) * in.stride;
+        halveRow(r0, r0 + in.stride, buffer.data() + size_t(y) * width, 0, width);
+    }
+
+    return Plane { buffer.data(), width, height, width };
+}
+
+// 面积平均：把 count 个源像素（间隔 step）缩放成 dcount 个目标像素（间隔 dstep），坐标用 16.16 定点数
+void areaLine(const quint32 *s, int count, int step, quint32 *d, int dcount, int dstep)
+{
+    for (int i = 0; i < dcount; ++i) {
+        const qint64 begin = (qint64(i) * count << 16) / dcount;
+        const qint64 end = (qint64(i + 1) * count << 16) / dcount;
+
+        quint64 acc[4] = { 0, 0, 0, 0 };
+        for (qint64 p = begin; p < end;) {
+            const qint64 index = p >> 16;
+            const qint64 next = qMin((index + 1) << 16, end);
+            const quint64 weight = quint64(next - p);
+            const quint32 pixel = s[index * step];
+
+            acc[0] += (pixel & 0xff) * weight;
+            acc[1] += ((pixel >> 8) & 0xff) * weight;
+            acc[2] += ((pixel >> 16) & 0xff) * weight;
+            acc[3] += (pixel >> 24) * weight;
+            p = next;
+        }
+
+        const quint64 total = quint64(end - begin);
+        quint32 pixel = 0;
+        for (int c = 0; c < 4; ++c)
+            pixel |= quint32((acc[c] + total / 2) / total) << (8 * c);
+        d[i * dstep] = pixel;
+    }
+}
+
+void areaScale(const Plane &in, quint32 *out, int width, int height, int stride, std::vector<quint32> &buffer)
+{
+    buffer.resize(size_t(width) * in.height);
+
+    for (int y = 0; y < in.height; ++y)
+        areaLine(in.bits + size_t(y) * in.stride, in.width, 1, buffer.data() + size_t(y) * width, width, 1);
+
+    for (int x = 0; x < width; ++x)
+        areaLine(buffer.data() + x, in.height, width, out + x, height, stride);
+}
+
+} // namespace
+
+void ThumbnailScaler::scale(const QImage &src, const QRect &srcRect, const QSize &size, QImage &dst)
+{
+    const QRect r = srcRect.intersected(src.rect());
+    if (r.isEmpty() || size.isEmpty()) {
+        dst = QImage();
+        return;
+    }
+
+    // 窗口比预览区域还小时需要放大，这种情况很少见，直接交给 Qt
+    if (size.width() > r.width() || size.height() > r.height()) {
+        dst = src.copy(r).scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        return;
+    }
+
+    // 逐通道平均只对不透明或预乘格式成立，其他格式先转换裁剪后的区域
+    QImage converted;
+    const QImage *source = &src;
+    QPoint origin = r.topLeft();
+    QImage::Format format = src.format();
+    if (format != QImage::Format_RGB32 && format != QImage::Format_ARGB32_Premultiplied) {
+        format = QImage::Format_ARGB32_Premultiplied;
+        converted = src.copy(r).convertToFormat(format);
+        source = &converted;
+        origin = QPoint(0, 0);
+    }
+
+    Plane plane { reinterpret_cast<const quint32 *>(source->constScanLine(origin.y())) + origin.x(),
+                  r.width(), r.height(), source->bytesPerLine() / 4 };
+
+    thread_local std::vector<quint32> halves[2];
+    thread_local std::vector<quint32> columns;
+
+    int current = 0;
+    while (plane.width >= size.width() * 2 && plane.height >= size.height() * 2) {
+        plane = halve(plane, halves[current]);
+        current ^= 1;
+    }
+
+    if (dst.size() != size || dst.format() != format)
+        dst = QImage(size, format);
+
+    areaScale(plane, reinterpret_cast<quint32 *>(dst.bits()), size.width(), size.height(), dst.bytesPerLine() / 4, columns);
+}
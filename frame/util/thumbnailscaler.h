@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef THUMBNAILSCALER_H
+#define THUMBNAILSCALER_H
+
+#include <QImage>
+#include <QRect>
+#include <QSize>
+
+/**
+ * @brief The ThumbnailScaler class
+ * 窗口预览图专用的缩小算法：先按 srcRect 裁剪，再用多级 2x2 box 滤波（ThumbnailKernels，SSE2/AVX2/NEON，
+ * 不支持时退回标量实现）缩小到接近目标尺寸，最后做一次面积平均得到精确尺寸。
+ * 中间缓冲区按线程复用，dst 尺寸和格式不变时直接写回 dst 的像素内存。
+ */
+class ThumbnailScaler
+{
+public:
+    static void scale(const QImage &src, const QRect &srcRect, const QSize &size, QImage &dst);
+};
+
+#endif // THUMBNAILSCALER_H
@@ -23,15 +23,50 @@
 #include "../item/appitem.h"
 #include "../item/trashitem.h"
 #include "../util/utils.h"
+#include "../util/thumbnailcache.h"
+#include "../util/settingswriter.h"
 
 #include <QSet>
+#include <QFile>
+#include <QTimer>
+#include <QThread>
+#include <QFileSystemWatcher>
 #include <DApplication>
 
 DockItemManager::DockItemManager() : QObject()
     , m_taskmanager(TaskManager::instance())
     , m_qsettings(new QSettings(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + "/setting.ini", QSettings::IniFormat))
+    , m_writeTimer(new QTimer(this))
+    , m_writerThread(new QThread(this))
+    , m_settingsWriter(new SettingsWriter(m_qsettings->fileName()))
+    , m_settingWatcher(new QFileSystemWatcher(this))
+    , m_thumbnailScheduler(new ThumbnailScheduler(this))
 {
     m_qsettings->setIniCodec(QTextCodec::codecForName("UTF-8"));
+    loadPreferences();
+
+    // 连续的设置修改合并后交给写入线程
+    m_writeTimer->setSingleShot(true);
+    m_writeTimer->setInterval(300);
+    connect(m_writeTimer, &QTimer::timeout, this, [this] { flushPreferences(); });
+
+    m_settingsWriter->moveToThread(m_writerThread);
+    connect(m_writerThread, &QThread::finished, m_settingsWriter, &QObject::deleteLater);
+    connect(m_settingsWriter, &SettingsWriter::written, this, [this](const QVariantMap &values) {
+        for (auto it = values.constBegin(); it != values.constEnd(); ++it)
+            if (m_inflightWrites.value(it.key()) == it.value())
+                m_inflightWrites.remove(it.key());
+
+        if (m_settingWatcher->files().isEmpty())
+            m_settingWatcher->addPath(m_qsettings->fileName());
+    });
+    m_writerThread->setObjectName("SettingsWriter");
+    m_writerThread->start(QThread::LowPriority);
+
+    // 外部修改配置文件时重新读取
+    if (QFile::exists(m_qsettings->fileName()))
+        m_settingWatcher->addPath(m_qsettings->fileName());
+    connect(m_settingWatcher, &QFileSystemWatcher::fileChanged, this, &DockItemManager::onSettingFileChanged);
 
     // 应用信号
     connect(m_taskmanager, &TaskManager::entryAdded, this, [this](const Entry *entry, int index){
@@ -41,10 +76,20 @@ DockItemManager::DockItemManager() : QObject()
     connect(m_taskmanager, &TaskManager::serviceRestarted, this, &DockItemManager::reloadAppItems);
     // connect(DockSettings::instance(), &DockSettings::showMultiWindowChanged, this, &DockItemManager::onShowMultiWindowChanged);
 
+    // 窗口缩略图缓存
+    ThumbnailCache::instance()->setMemoryLimit(thumbnailCacheSize() * 1024 * 1024);
+    connect(m_taskmanager, &TaskManager::windowDetached, ThumbnailCache::instance(), &ThumbnailCache::remove);
+    m_thumbnailScheduler->setCapturesPerSecond(thumbnailRefreshRate());
+
     if (Dtk::Widget::DApplication *app = qobject_cast<Dtk::Widget::DApplication *>(qApp)) {
         connect(app, &Dtk::Widget::DApplication::iconThemeChanged, this, &DockItemManager::refreshItemsIcon);
     }
 
+    connect(qApp, &QApplication::aboutToQuit, this, [this] {
+        flushPreferences(true);
+        m_writerThread->quit();
+        m_writerThread->wait();
+    });
     connect(qApp, &QApplication::aboutToQuit, this, &QObject::deleteLater);
 
     // reloadAppItems();
@@ -70,76 +115,202 @@ void DockItemManager::refreshItemsIcon() {
     }
 }
 
+void DockItemManager::loadPreferences()
+{
+    static const QList<QPair<QString, QVariant>> defaults = {
+        { "mergeMode", MergeDock },
+        { "animation/hover", true },
+        { "animation/inout", true },
+        { "animation/drag", true },
+        { "animation/highlight", true },
+        { "animation/activate", Jump },
+        { "thumbnail/cacheSize", 64 },
+        { "thumbnail/refreshRate", 2 },
+        { "render/singleSurface", false },
+    };
+
+    for (const auto &item : defaults)
+        applyPreference(item.first, m_qsettings->value(item.first, item.second));
+}
+
+void DockItemManager::applyPreference(const QString &key, const QVariant &value)
+{
+    if (key == "mergeMode") {
+        const int mode = value.toInt();
+        m_preferences.mergeMode = MergeMode(mode < 0 || mode > 1 ? 0 : mode);
+    } else if (key == "animation/hover") {
+        m_preferences.hoverScaleAnimation = value.toBool();
+    } else if (key == "animation/inout") {
+        m_preferences.inOutAnimation = value.toBool();
+    } else if (key == "animation/drag") {
+        m_preferences.dragAnimation = value.toBool();
+    } else if (key == "animation/highlight") {
+        m_preferences.hoverHighlight = value.toBool();
+    } else if (key == "animation/activate") {
+        m_preferences.animationType = ActivateAnimationType(qBound(int(Swing), value.toInt(), int(No)));
+    } else if (key == "thumbnail/cacheSize") {
+        m_preferences.thumbnailCacheSize = qBound(0, value.toInt(), 1024);
+    } else if (key == "thumbnail/refreshRate") {
+        m_preferences.thumbnailRefreshRate = qBound(1, value.toInt(), 60);
+    } else if (key == "render/singleSurface") {
+        m_preferences.singleSurface = value.toBool();
+    }
+}
+
+void DockItemManager::setPreference(const QString &key, const QVariant &value)
+{
+    applyPreference(key, value);
+    m_pendingWrites.insert(key, value);
+    if (!m_writeTimer->isActive())
+        m_writeTimer->start();
+}
+
+void DockItemManager::flushPreferences(bool wait)
+{
+    if (m_pendingWrites.isEmpty() || !m_writerThread->isRunning())
+        return;
+
+    const QVariantMap values = m_pendingWrites;
+    m_pendingWrites.clear();
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it)
+        m_inflightWrites.insert(it.key(), it.value());
+
+    QMetaObject::invokeMethod(m_settingsWriter, "write", wait ? Qt::BlockingQueuedConnection : Qt::QueuedConnection, Q_ARG(QVariantMap, values));
+}
+
+void DockItemManager::onSettingFileChanged(const QString &path)
+{
+    // QSettings 以替换文件的方式写入，监听会失效，需要重新添加
+    if (!m_settingWatcher->files().contains(path) && QFile::exists(path))
+        m_settingWatcher->addPath(path);
+
+    const Preferences old = m_preferences;
+    m_qsettings->sync();
+    loadPreferences();
+
+    // 还没有写入文件的修改以内存中的值为准
+    for (const QVariantMap *writes : { &m_inflightWrites, &m_pendingWrites })
+        for (auto it = writes->constBegin(); it != writes->constEnd(); ++it)
+            applyPreference(it.key(), it.value());
+
+    if (old.mergeMode != m_preferences.mergeMode)
+        emit mergeModeChanged(m_preferences.mergeMode);
+    if (old.hoverHighlight != m_preferences.hoverHighlight)
+        emit hoverHighlighted(m_preferences.hoverHighlight);
+    if (old.singleSurface != m_preferences.singleSurface)
+        emit singleSurfaceChanged(m_preferences.singleSurface);
+    if (old.thumbnailCacheSize != m_preferences.thumbnailCacheSize)
+        ThumbnailCache::instance()->setMemoryLimit(m_preferences.thumbnailCacheSize * 1024 * 1024);
+    if (old.thumbnailRefreshRate != m_preferences.thumbnailRefreshRate)
+        m_thumbnailScheduler->setCapturesPerSecond(m_preferences.thumbnailRefreshRate);
+}
+
 MergeMode DockItemManager::getDockMergeMode()
 {
-    int i = m_qsettings->value("mergeMode", MergeDock).toInt();
-    if(i < 0 || i > 1)
-        i = 0;
-    return MergeMode(i);
+    return m_preferences.mergeMode;
 }
 
 void DockItemManager::saveDockMergeMode(MergeMode mode)
 {
     if(mode != getDockMergeMode())
     {
-        m_qsettings->setValue("mergeMode", mode);
-        m_qsettings->sync();
+        setPreference("mergeMode", int(mode));
         emit mergeModeChanged(mode);
     }
 }
 
 bool DockItemManager::isEnableHoverScaleAnimation()
 {
-    return m_qsettings->value("animation/hover", true).toBool();
+    return m_preferences.hoverScaleAnimation;
 }
 
 bool DockItemManager::isEnableInOutAnimation()
 {
-    return m_qsettings->value("animation/inout", true).toBool();
+    return m_preferences.inOutAnimation;
 }
 
 bool DockItemManager::isEnableDragAnimation()
 {
-    return m_qsettings->value("animation/drag", true).toBool();
+    return m_preferences.dragAnimation;
 }
 
 bool DockItemManager::isEnableHoverHighlight()
 {
-    return m_qsettings->value("animation/highlight", true).toBool();
+    return m_preferences.hoverHighlight;
 }
 
 void DockItemManager::setHoverScaleAnimation(bool enable)
 {
     if(enable != isEnableHoverScaleAnimation())
-        m_qsettings->setValue("animation/hover", enable);
+        setPreference("animation/hover", enable);
 }
 
 void DockItemManager::setInOutAnimation(bool enable)
 {
     if(enable != isEnableInOutAnimation())
-        m_qsettings->setValue("animation/inout", enable);
+        setPreference("animation/inout", enable);
 }
 
 void DockItemManager::setDragAnimation(bool enable)
 {
-    m_qsettings->setValue("animation/drag", enable);
+    if(enable != isEnableDragAnimation())
+        setPreference("animation/drag", enable);
 }
 
 void DockItemManager::setHoverHighlight(bool enable)
 {
     if(isEnableHoverHighlight() != enable) {
-        m_qsettings->setValue("animation/highlight", enable);
+        setPreference("animation/highlight", enable);
         emit hoverHighlighted(enable);
     }
 }
 
 DockItemManager::ActivateAnimationType DockItemManager::animationType() {
-    return m_qsettings->value("animation/activate", Jump).value<ActivateAnimationType>();
+    return m_preferences.animationType;
 }
 
 void DockItemManager::setAnimationType(ActivateAnimationType type) {
-    m_qsettings->setValue("animation/activate", type);
-    m_qsettings->sync();
+    if(type != animationType())
+        setPreference("animation/activate", int(type));
+}
+
+// 缩略图缓存的内存上限，单位 MB
+int DockItemManager::thumbnailCacheSize()
+{
+    return m_preferences.thumbnailCacheSize;
+}
+
+void DockItemManager::setThumbnailCacheSize(int size)
+{
+    size = qBound(0, size, 1024);
+    setPreference("thumbnail/cacheSize", size);
+    ThumbnailCache::instance()->setMemoryLimit(size * 1024 * 1024);
+}
+
+// 定时刷新缩略图时每秒最多截图的次数
+int DockItemManager::thumbnailRefreshRate()
+{
+    return m_preferences.thumbnailRefreshRate;
+}
+
+void DockItemManager::setThumbnailRefreshRate(int count)
+{
+    count = qBound(1, count, 60);
+    setPreference("thumbnail/refreshRate", count);
+    m_thumbnailScheduler->setCapturesPerSecond(count);
+}
+
+bool DockItemManager::isEnableSingleSurface()
+{
+    return m_preferences.singleSurface;
+}
+
+void DockItemManager::setSingleSurface(bool enable)
+{
+    if(isEnableSingleSurface() != enable) {
+        setPreference("render/singleSurface", enable);
+        emit singleSurfaceChanged(enable);
+    }
 }
 
 bool DockItemManager::hasWindowItem()
@@ -29,8 +29,15 @@
 #include "../item/diritem.h"
 #include "../item/folderitem.h"
 #include "../taskmanager/taskmanager.h"
+#include "thumbnailscheduler.h"
 
 #include <QObject>
+#include <QVariantMap>
+
+class QThread;
+class QTimer;
+class QFileSystemWatcher;
+class SettingsWriter;
 
 class DockItemManager : public QObject
 {
@@ -44,6 +51,19 @@ public:
         No = 4
     };
 
+    // setting.ini 中的界面选项，启动时读取一次，之后只在内存中读取
+    struct Preferences {
+        MergeMode mergeMode;
+        bool hoverScaleAnimation;
+        bool inOutAnimation;
+        bool dragAnimation;
+        bool hoverHighlight;
+        ActivateAnimationType animationType;
+        int thumbnailCacheSize;
+        int thumbnailRefreshRate;
+        bool singleSurface;
+    };
+
     static DockItemManager *instance();
 
     const QList<QPointer<AppItem> > itemList();
@@ -62,6 +82,13 @@ public:
     void setHoverHighlight(bool enable);
     ActivateAnimationType animationType();
     void setAnimationType(ActivateAnimationType type);
+    int thumbnailCacheSize();
+    void setThumbnailCacheSize(int size);
+    int thumbnailRefreshRate();
+    void setThumbnailRefreshRate(int count);
+    ThumbnailScheduler *thumbnailScheduler() const { return m_thumbnailScheduler; }
+    bool isEnableSingleSurface();
+    void setSingleSurface(bool enable);
     bool hasWindowItem();
     int itemSize();
     int itemCount();
@@ -73,6 +100,7 @@ signals:
     void mergeModeChanged(MergeMode mode);
     void itemCountChanged();
     void hoverHighlighted(bool enabled);
+    void singleSurfaceChanged(bool enabled);
     void requestUpdateDockItem() const;
 
 
@@ -92,6 +120,12 @@ private:
     void loadDirAppData();
     void loadFolderData();
 
+    void loadPreferences();
+    void applyPreference(const QString &key, const QVariant &value);
+    void setPreference(const QString &key, const QVariant &value);
+    void flushPreferences(bool wait = false);
+    void onSettingFileChanged(const QString &path);
+
     void onAppWindowCountChanged();
     // void onShowMultiWindowChanged();
 
@@ -103,6 +137,14 @@ private:
 private:
     TaskManager *m_taskmanager;
     QSettings *m_qsettings;
+    Preferences m_preferences;
+    QVariantMap m_pendingWrites;    // 等待合并写入的修改
+    QVariantMap m_inflightWrites;   // 已交给写入线程但尚未完成的修改
+    QTimer *m_writeTimer;
+    QThread *m_writerThread;
+    SettingsWriter *m_settingsWriter;
+    QFileSystemWatcher *m_settingWatcher;
+    ThumbnailScheduler *m_thumbnailScheduler;
 
     QList<QPointer<AppItem>> m_itemList;
     QList<QString> m_appIDist;
@@ -26,6 +26,8 @@
 #include "../item/appitem.h"
 #include "dockitemmanager.h"
 #include "../item/diritem.h"
+#include "../util/animationclock.h"
+#include "../util/perfstatistics.h"
 
 #include <dtkwidget_global.h>
 #include <dtkgui_global.h>
@@ -35,9 +37,17 @@
 #include <QString>
 #include <QApplication>
 #include <QPointer>
+#include <QPainter>
+#include <QMouseEvent>
+#include <QWheelEvent>
+#include <QHelpEvent>
+#include <QAccessible>
+#include <QAccessibleWidget>
 #include <DGuiApplicationHelper>
 #include <DWindowManagerHelper>
 
+#include <algorithm>
+
 #define SPLITER_SIZE 3
 #define MODE_PADDING 5
 
@@ -46,7 +56,7 @@ DGUI_USE_NAMESPACE
 
 class SplitterWidget : public QWidget {
     public:
-        explicit SplitterWidget(MainPanelControl *parent) : QWidget(parent), m_parent(parent) {
+        explicit SplitterWidget(MainPanelControl *parent) : QWidget(parent), m_parent(parent), dragging(false) {
             m_type = DGuiApplicationHelper::instance()->themeType();
             connect(DGuiApplicationHelper::instance(), &DGuiApplicationHelper::themeTypeChanged, this, [this](DGuiApplicationHelper::ColorType type) {
                 m_type = type;
@@ -88,6 +98,8 @@ class SplitterWidget : public QWidget {
             releaseMouse();
             if(dragging) {
                 dragging = false;
+                // 先应用还在等待下一帧的最后一次尺寸
+                AnimationClock::instance()->flush();
                 emit m_parent->requestResizeDockSize(m_parent->isHorizontal() ? m_parent->height() : m_parent->width(), false);
             }
         }
@@ -111,7 +123,12 @@ class SplitterWidget : public QWidget {
                 if(m_parent->m_position == Bottom) s = lastSize - diffPos.y();
                 else if(m_parent->m_position == Left) s = lastSize + diffPos.x();
                 else if(m_parent->m_position == Right) s = lastSize - diffPos.x();
-                emit m_parent->requestResizeDockSize(s, true);
+
+                // 高回报率鼠标的移动事件远多于屏幕刷新，每帧只调整一次尺寸
+                AnimationClock::instance()->runOnFrame(this, [this, s] {
+                    PERF_SCOPE("resize", "SplitterDrag");
+                    emit m_parent->requestResizeDockSize(s, true);
+                });
             }
         }
 
@@ -124,6 +141,122 @@ class SplitterWidget : public QWidget {
         bool dragging;
 };
 
+/**
+ * @brief The SurfaceItemAccessible class
+ * 统一绘制时 DockItem 控件本身隐藏，无障碍信息取面板上的位置和提示文字，点击和菜单操作转为鼠标事件
+ */
+class SurfaceItemAccessible : public QAccessibleInterface, public QAccessibleActionInterface
+{
+public:
+    explicit SurfaceItemAccessible(DockItem *item) : m_item(item) {}
+
+    bool isValid() const override { return m_item && m_item->parentWidget(); }
+    QObject *object() const override { return m_item; }
+    QWindow *window() const override { return m_item->window()->windowHandle(); }
+    QAccessibleInterface *parent() const override { return QAccessible::queryAccessibleInterface(m_item->parentWidget()); }
+    QAccessibleInterface *child(int) const override { return nullptr; }
+    int childCount() const override { return 0; }
+    int indexOfChild(const QAccessibleInterface *) const override { return -1; }
+    QAccessibleInterface *childAt(int, int) const override { return nullptr; }
+
+    QString text(QAccessible::Text t) const override {
+        if (t == QAccessible::Name)
+            return m_item->accessibleText();
+        if (t == QAccessible::Description)
+            return m_item->accessibleDescription();
+        return QString();
+    }
+    void setText(QAccessible::Text, const QString &) override {}
+    // 控件隐藏时的 geometry 由 layoutSurface() 同步为面板上的位置
+    QRect rect() const override { return QRect(m_item->parentWidget()->mapToGlobal(m_item->pos()), m_item->size()); }
+    QAccessible::Role role() const override { return QAccessible::Button; }
+    QAccessible::State state() const override {
+        QAccessible::State state;
+        state.invisible = !m_item->isVisibleOnDock();
+        state.hotTracked = m_item->underMouse();
+        return state;
+    }
+    void *interface_cast(QAccessible::InterfaceType type) override {
+        return type == QAccessible::ActionInterface ? static_cast<QAccessibleActionInterface *>(this) : nullptr;
+    }
+
+    QStringList actionNames() const override { return { pressAction(), showMenuAction() }; }
+    void doAction(const QString &actionName) override {
+        const Qt::MouseButton button = actionName == showMenuAction() ? Qt::RightButton : Qt::LeftButton;
+        const QPoint pos = m_item->rect().center();
+        const QPoint globalPos = rect().center();
+        QMouseEvent press(QEvent::MouseButtonPress, pos, globalPos, button, button, Qt::NoModifier);
+        QMouseEvent release(QEvent::MouseButtonRelease, pos, globalPos, button, Qt::NoButton, Qt::NoModifier);
+        QCoreApplication::sendEvent(m_item, &press);
+        QCoreApplication::sendEvent(m_item, &release);
+    }
+    QStringList keyBindingsForAction(const QString &) const override { return QStringList(); }
+
+private:
+    QPointer<DockItem> m_item;
+};
+
+/**
+ * @brief The MainPanelAccessible class
+ * 统一绘制时面板的无障碍子节点取自 MainPanelControl 的项列表
+ */
+class MainPanelAccessible : public QAccessibleWidget
+{
+public:
+    explicit MainPanelAccessible(MainPanelControl *panel) : QAccessibleWidget(panel, QAccessible::Pane) {}
+
+    int childCount() const override {
+        if (!panel()->m_singleSurface)
+            return QAccessibleWidget::childCount();
+        return panel()->m_items.size();
+    }
+    QAccessibleInterface *child(int index) const override {
+        if (!panel()->m_singleSurface)
+            return QAccessibleWidget::child(index);
+        if (index < 0 || index >= panel()->m_items.size())
+            return nullptr;
+        return QAccessible::queryAccessibleInterface(panel()->m_items.at(index).item);
+    }
+    int indexOfChild(const QAccessibleInterface *child) const override {
+        if (!panel()->m_singleSurface)
+            return QAccessibleWidget::indexOfChild(child);
+        for (int i = 0; i < panel()->m_items.size(); ++i)
+            if (panel()->m_items.at(i).item.data() == child->object())
+                return i;
+        return -1;
+    }
+    QAccessibleInterface *childAt(int x, int y) const override {
+        if (!panel()->m_singleSurface)
+            return QAccessibleWidget::childAt(x, y);
+        const int index = panel()->surfaceItemAt(panel()->mapFromGlobal(QPoint(x, y)));
+        return index == -1 ? nullptr : child(index);
+    }
+
+private:
+    MainPanelControl *panel() const { return static_cast<MainPanelControl *>(widget()); }
+};
+
+static QAccessibleInterface *panelAccessibleFactory(const QString &classname, QObject *object)
+{
+    Q_UNUSED(classname)
+
+    if (MainPanelControl *panel = qobject_cast<MainPanelControl *>(object))
+        return new MainPanelAccessible(panel);
+
+    DockItem *item = qobject_cast<DockItem *>(object);
+    if (item && item->isPaintedBySurface())
+        return new SurfaceItemAccessible(item);
+
+    return nullptr;
+}
+
+// 统一绘制时控件本身隐藏，但不标记为显式隐藏，移入文件夹等其他布局后仍会自动显示
+static void hideForSurface(QWidget *widget)
+{
+    widget->hide();
+    widget->setAttribute(Qt::WA_WState_ExplicitShowHide, false);
+}
+
 int beforeIndex = -1;
 static AppDrag *appDrag(nullptr);
 
@@ -136,11 +269,30 @@ MainPanelControl::MainPanelControl(QWidget *parent) : QWidget(parent)
     , m_splitter2(new SplitterWidget(this))
     , m_position(Position::Bottom)
     , m_placeholderItem(nullptr)
+    , m_singleSurface(false)
+    , m_surfaceLayoutPending(false)
+    , m_layoutRequestPosted(false)
+    , m_dragAcceptedByPanel(false)
+    , m_appAreaIndexDirty(true)
+#ifdef ENABLE_PERF_TIMERS
+    , m_layoutProbe(new PerfLayoutProbe(this, "MainPanelControl"))
+#endif
 {
+    static bool accessibleInstalled = false;
+    if (!accessibleInstalled) {
+        QAccessible::installFactory(panelAccessibleFactory);
+        accessibleInstalled = true;
+    }
+
+    std::fill(std::begin(m_areaCounts), std::end(m_areaCounts), 0);
+
     init();
     updateMainPanelLayout();
     m_splitter->hide();
     setAcceptDrops(true);
+
+    setSingleSurface(DockItemManager::instance()->isEnableSingleSurface());
+    connect(DockItemManager::instance(), &DockItemManager::singleSurfaceChanged, this, &MainPanelControl::setSingleSurface);
 }
 
 MainPanelControl::~MainPanelControl(){}
@@ -207,40 +359,604 @@ void MainPanelControl::updateMainPanelLayout()
             break;
     }
     resizeDockIcon();
+    invalidateItemLayout();
 }
 
-void MainPanelControl::addFixedAreaItem(int index, QWidget *wdg)
+void MainPanelControl::addFixedAreaItem(int index, DockItem *item)
 {
-    wdg->setFixedSize(DockItemManager::instance()->itemSize(), DockItemManager::instance()->itemSize());
-    m_fixedAreaLayout->insertWidget(index, wdg);
+    item->setFixedSize(DockItemManager::instance()->itemSize(), DockItemManager::instance()->itemSize());
+    insertAreaItem(FixedArea, index, item);
 }
 
-void MainPanelControl::addAppAreaItem(int index, QWidget *wdg)
+void MainPanelControl::addAppAreaItem(int index, DockItem *item)
 {
     // wdg->setFixedSize(DockSettings::Instance().itemSize(), DockSettings::Instance().itemSize());
-    m_appAreaLayout->insertWidget(index, wdg, 0, Qt::AlignCenter);
+    insertAreaItem(AppArea, index, item);
 }
 
 void MainPanelControl::removeAppAreaItem(QWidget *wdg)
 {
-    m_appAreaLayout->removeWidget(wdg);
+    removeAreaItem(AppArea, wdg);
 }
 
-void MainPanelControl::addWindowAreaItem(int index, QWidget *wdg)
+void MainPanelControl::addWindowAreaItem(int index, DockItem *item)
 {
-    m_windowAreaLayout->insertWidget(index, wdg, 0, Qt::AlignCenter);
+    insertAreaItem(WindowArea, index, item);
     m_splitter->show();
+    invalidateItemLayout();
+}
+
+void MainPanelControl::addLastAreaItem(int index, DockItem *item)
+{
+    item->setFixedSize(DockItemManager::instance()->itemSize(), DockItemManager::instance()->itemSize());
+    insertAreaItem(LastArea, index, item);
+}
+
+/**
+ * @brief MainPanelControl::setItemSize 设置面板上某一项的尺寸，统一绘制时只重新计算各项位置
+ */
+void MainPanelControl::setItemSize(DockItem *item, const QSize &size)
+{
+    if(item->size() == size) return;
+
+    item->setFixedSize(size);
+    invalidateItemLayout();
+}
+
+/**
+ * @brief MainPanelControl::setItemSizeOnFrame 在下一帧设置项的尺寸，同一帧内只保留最后一次的值
+ */
+void MainPanelControl::setItemSizeOnFrame(DockItem *item, const QSize &size)
+{
+    AnimationClock::instance()->runOnFrame(item, [this, item, size] { setItemSize(item, size); });
+}
+
+QBoxLayout *MainPanelControl::areaLayout(Area area) const
+{
+    switch (area) {
+        case FixedArea: return m_fixedAreaLayout;
+        case AppArea: return m_appAreaLayout;
+        case WindowArea: return m_windowAreaLayout;
+        case LastArea: return m_lastAreaLayout;
+    }
+    return nullptr;
+}
+
+int MainPanelControl::areaBegin(Area area) const
+{
+    int begin = 0;
+    for(int i = FixedArea; i < area; ++i)
+        begin += m_areaCounts[i];
+    return begin;
+}
+
+DockItem *MainPanelControl::areaItemAt(Area area, int index) const
+{
+    if(index < 0 || index >= m_areaCounts[area]) return nullptr;
+
+    return m_items.at(areaBegin(area) + index).item;
+}
+
+int MainPanelControl::areaIndexOf(Area area, const QWidget *item) const
+{
+    const int begin = areaBegin(area);
+    for(int i = 0; i < m_areaCounts[area]; ++i)
+        if(m_items.at(begin + i).item.data() == item)
+            return i;
+    return -1;
+}
+
+QRect MainPanelControl::areaGeometry(Area area)
+{
+    if(!m_singleSurface) return areaLayout(area)->geometry();
+
+    if(m_surfaceLayoutPending) layoutSurface();
+    return m_areaRects[area];
+}
+
+/**
+ * @brief MainPanelControl::insertAreaItem 把项插入到某个区域的 index 位置，index 为 -1 或越界时追加到末尾。
+ * 统一绘制时控件隐藏，只记录在项列表中；否则同时插入对应区域的 QBoxLayout
+ */
+void MainPanelControl::insertAreaItem(Area area, int index, DockItem *item)
+{
+    // 与 QLayout 一样，已在面板上的项先移除再插入
+    removeItemFromList(item);
+    if(index < 0 || index > m_areaCounts[area])
+        index = m_areaCounts[area];
+
+    m_items.insert(areaBegin(area) + index, PanelItem { item, area, QRect() });
+    ++m_areaCounts[area];
+    connect(item, &QObject::destroyed, this, &MainPanelControl::removeDestroyedItems, Qt::UniqueConnection);
+
+    if(m_singleSurface) {
+        if(item->parentWidget() != this)
+            item->setParent(this);
+        hideForSurface(item);
+        item->setPaintedBySurface(true);
+        if(QAccessible::isActive()) {
+            QAccessibleEvent event(this, QAccessible::ObjectReorder);
+            QAccessible::updateAccessibility(&event);
+        }
+    } else {
+        const bool center = area == AppArea || area == WindowArea;
+        areaLayout(area)->insertWidget(index, item, 0, center ? Qt::AlignCenter : Qt::Alignment());
+    }
+
+    invalidateItemLayout();
+}
+
+void MainPanelControl::removeAreaItem(Area area, const QWidget *item)
+{
+    const int index = areaIndexOf(area, item);
+    if(index == -1) return;
+
+    const PanelItem removed = m_items.takeAt(areaBegin(area) + index);
+    --m_areaCounts[area];
+
+    if(m_singleSurface) {
+        update(removed.geometry);
+        if(m_hoverItem.data() == item) m_hoverItem = nullptr;
+        if(QAccessible::isActive()) {
+            QAccessibleEvent event(this, QAccessible::ObjectReorder);
+            QAccessible::updateAccessibility(&event);
+        }
+    } else {
+        areaLayout(area)->removeWidget(removed.item);
+    }
+
+    invalidateItemLayout();
+}
+
+void MainPanelControl::removeItemFromList(const QWidget *item)
+{
+    for(const PanelItem &entry : m_items)
+        if(entry.item.data() == item)
+            return removeAreaItem(entry.area, item);
+}
+
+// 项被删除时 QPointer 已经置空，QBoxLayout 会自行移除对应的控件
+void MainPanelControl::removeDestroyedItems()
+{
+    for(int i = m_items.size() - 1; i >= 0; --i) {
+        if(m_items.at(i).item) continue;
+
+        update(m_items.at(i).geometry);
+        --m_areaCounts[m_items.at(i).area];
+        m_items.remove(i);
+    }
+    invalidateItemLayout();
+}
+
+QRect MainPanelControl::itemGeometry(int index) const
+{
+    const PanelItem &entry = m_items.at(index);
+    return m_singleSurface ? entry.geometry : entry.item->geometry();
+}
+
+/**
+ * @brief MainPanelControl::invalidateItemLayout 项或尺寸变化后调用，投递一次 LayoutRequest，
+ * 同一轮事件循环内的多次变化只布局一次。非统一绘制时 QBoxLayout 也会投递，Qt 会合并同一对象上未处理的
+ * LayoutRequest，这里投递保证计时在之后结束
+ */
+void MainPanelControl::invalidateItemLayout()
+{
+    m_appAreaIndexDirty = true;
+    m_surfaceLayoutPending = m_surfaceLayoutPending || m_singleSurface;
+
+#ifdef ENABLE_PERF_TIMERS
+    m_layoutProbe->arm();
+#endif
+
+    if(m_layoutRequestPosted) return;
+
+    m_layoutRequestPosted = true;
+    QCoreApplication::postEvent(this, new QEvent(QEvent::LayoutRequest));
+}
+
+/**
+ * @brief MainPanelControl::layoutSurface 统一绘制时按各项尺寸计算位置，结果与非统一绘制时的 QBoxLayout 一致：
+ * 固定区、应用区、分隔线、窗口区、分隔线、插件区依次排列并整体居中，空的部分不占间距
+ */
+void MainPanelControl::layoutSurface()
+{
+    m_surfaceLayoutPending = false;
+    m_appAreaIndexDirty = true;
+
+    const bool horizontal = isHorizontal();
+    const int length = horizontal ? width() : height();
+    const int thickness = horizontal ? height() : width();
+    auto mainSize = [horizontal](const QSize &size) { return horizontal ? size.width() : size.height(); };
+    auto crossSize = [horizontal](const QSize &size) { return horizontal ? size.height() : size.width(); };
+    auto makeRect = [horizontal](int pos, int cross, const QSize &size) {
+        return horizontal ? QRect(QPoint(pos, cross), size) : QRect(QPoint(cross, pos), size);
+    };
+
+    int areaLength[LastArea + 1] = {};
+    int index = 0;
+    for(int area = FixedArea; area <= LastArea; ++area) {
+        for(int i = 0; i < m_areaCounts[area]; ++i, ++index)
+            areaLength[area] += mainSize(m_items.at(index).item->size());
+        if(m_areaCounts[area] > 1)
+            areaLength[area] += MODE_PADDING * (m_areaCounts[area] - 1);
+    }
+
+    // 分隔线分别在窗口区和插件区之前；与 QBoxLayout 相同，只有前面已有非空的段时才计入间距
+    QWidget *splitters[LastArea + 1] = { nullptr, nullptr, m_splitter, m_splitter2 };
+    int total = 0;
+    bool empty = true;
+    for(int area = FixedArea; area <= LastArea; ++area) {
+        if(splitters[area] && !splitters[area]->isHidden()) {
+            total += (empty ? 0 : MODE_PADDING) + mainSize(splitters[area]->size());
+            empty = false;
+        }
+        if(m_areaCounts[area]) {
+            total += (empty ? 0 : MODE_PADDING) + areaLength[area];
+            empty = false;
+        }
+    }
+
+    QRect dirty;
+    QVector<QPair<QPointer<DockItem>, QRect>> moved;
+    int pos = (length - total) / 2;
+    bool first = true;
+    index = 0;
+    for(int area = FixedArea; area <= LastArea; ++area) {
+        if(splitters[area] && !splitters[area]->isHidden()) {
+            pos += first ? 0 : MODE_PADDING;
+            first = false;
+            const QSize size = splitters[area]->size();
+            splitters[area]->setGeometry(makeRect(pos, (thickness - crossSize(size)) / 2, size));
+            pos += mainSize(size);
+        }
+
+        if(m_areaCounts[area] == 0) {
+            m_areaRects[area] = makeRect(pos, 0, horizontal ? QSize(0, thickness) : QSize(thickness, 0));
+            continue;
+        }
+
+        pos += first ? 0 : MODE_PADDING;
+        first = false;
+        const int start = pos;
+        for(int i = 0; i < m_areaCounts[area]; ++i, ++index) {
+            PanelItem &entry = m_items[index];
+            const QSize size = entry.item->size();
+            const QRect rect = makeRect(pos, (thickness - crossSize(size)) / 2, size);
+            pos += mainSize(size) + (i + 1 < m_areaCounts[area] ? MODE_PADDING : 0);
+            if(rect == entry.geometry) continue;
+
+            dirty |= entry.geometry | rect;
+            moved.append(qMakePair(entry.item, entry.geometry));
+            entry.geometry = rect;
+            // 弹窗、图标区域等都依赖控件本身的位置
+            entry.item->setGeometry(rect);
+        }
+        m_areaRects[area] = makeRect(start, 0, horizontal ? QSize(pos - start, thickness) : QSize(thickness, pos - start));
+    }
+
+    if(!dirty.isEmpty())
+        update(dirty);
+
+    // 隐藏的控件不会收到移动和尺寸事件，布局完成后补发
+    for(const auto &pair : moved) {
+        DockItem *item = pair.first;
+        if(!item) continue;
+
+        const QRect &old = pair.second;
+        if(old.topLeft() != item->pos()) {
+            QMoveEvent event(item->pos(), old.topLeft());
+            QCoreApplication::sendEvent(item, &event);
+        }
+        if(pair.first && old.size() != item->size()) {
+            QResizeEvent event(item->size(), old.size());
+            QCoreApplication::sendEvent(item, &event);
+        }
+    }
+}
+
+/**
+ * @brief MainPanelControl::surfaceItemAt 统一绘制时各项沿任务栏方向依次排列，二分查找 pos 下的项
+ */
+int MainPanelControl::surfaceItemAt(const QPoint &pos)
+{
+    if(m_surfaceLayoutPending) layoutSurface();
+
+    const bool horizontal = isHorizontal();
+    const int p = horizontal ? pos.x() : pos.y();
+    const auto it = std::lower_bound(m_items.cbegin(), m_items.cend(), p, [horizontal](const PanelItem &entry, int p) {
+        return (horizontal ? entry.geometry.right() : entry.geometry.bottom()) < p;
+    });
+    if(it == m_items.cend() || !it->item || !it->geometry.contains(pos))
+        return -1;
+
+    return it - m_items.cbegin();
+}
+
+void MainPanelControl::setSingleSurface(bool enable)
+{
+    if(m_singleSurface == enable) return;
+
+    m_singleSurface = enable;
+    setMouseTracking(enable);
+    // 统一绘制时由 layoutSurface() 计算位置，分隔线仍是子控件
+    layout()->setEnabled(!enable);
+
+    QVector<PanelItem>::iterator it = m_items.begin();
+    for(int area = FixedArea; area <= LastArea; ++area) {
+        for(int i = 0; i < m_areaCounts[area]; ++i, ++it) {
+            DockItem *item = it->item;
+            if(enable) {
+                areaLayout(Area(area))->removeWidget(item);
+                it->geometry = QRect();
+            } else {
+                const bool center = area == AppArea || area == WindowArea;
+                areaLayout(Area(area))->insertWidget(i, item, 0, center ? Qt::AlignCenter : Qt::Alignment());
+            }
+        }
+    }
+
+    // 包括已经移出列表、等待删除的项
+    for(QObject *child : children()) {
+        if(DockItem *item = qobject_cast<DockItem *>(child)) {
+            item->setPaintedBySurface(enable);
+            if(enable)
+                hideForSurface(item);
+            else
+                item->show();
+        }
+    }
+
+    if(!enable) {
+        setHoverItem(nullptr, QPoint());
+        m_pressedItem = nullptr;
+        m_dropItem = nullptr;
+    }
+
+    invalidateItemLayout();
+    update();
+}
+
+void MainPanelControl::setHoverItem(DockItem *item, const QPoint &pos)
+{
+    if(m_hoverItem == item) return;
+
+    if(m_hoverItem) {
+        QEvent event(QEvent::Leave);
+        QCoreApplication::sendEvent(m_hoverItem, &event);
+    }
+
+    m_hoverItem = item;
+    if(item) {
+        QEnterEvent event(pos - item->pos(), mapTo(window(), pos), mapToGlobal(pos));
+        QCoreApplication::sendEvent(item, &event);
+    }
+}
+
+/**
+ * @brief MainPanelControl::forwardMouseEvent 统一绘制时把鼠标事件转发给鼠标下的项。
+ * 与 Qt 的隐式抓取一样，按下后的移动和释放都发给按下时的项；项忽略事件时返回 false，由面板继续处理
+ */
+bool MainPanelControl::forwardMouseEvent(QMouseEvent *event)
+{
+    const int index = surfaceItemAt(event->pos());
+    DockItem *item = index == -1 ? nullptr : m_items.at(index).item.data();
+    DockItem *target = nullptr;
+
+    switch (event->type()) {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonDblClick:
+            if(event->buttons() == event->button())
+                m_pressedItem = item;
+            target = m_pressedItem;
+            break;
+        case QEvent::MouseButtonRelease:
+            target = m_pressedItem;
+            break;
+        case QEvent::MouseMove:
+            if(event->buttons() != Qt::NoButton) {
+                target = m_pressedItem;
+            } else {
+                setHoverItem(item, event->pos());
+                // 与子控件一样，没有开启鼠标跟踪的项只在按下时收到移动事件
+                target = item && item->hasMouseTracking() ? item : nullptr;
+            }
+            break;
+        default:
+            break;
+    }
+
+    bool accepted = false;
+    if(target) {
+        QMouseEvent mapped(event->type(), event->localPos() - target->pos(), event->windowPos(), event->screenPos(),
+                           event->button(), event->buttons(), event->modifiers(), event->source());
+        mapped.setTimestamp(event->timestamp());
+        QCoreApplication::sendEvent(target, &mapped);
+        accepted = mapped.isAccepted();
+    }
+
+    if(event->type() == QEvent::MouseButtonRelease && event->buttons() == Qt::NoButton) {
+        m_pressedItem = nullptr;
+        // 点击可能移除了项，重新查找
+        const int current = surfaceItemAt(event->pos());
+        setHoverItem(current == -1 ? nullptr : m_items.at(current).item.data(), event->pos());
+    }
+
+    return accepted;
+}
+
+bool MainPanelControl::forwardWheelEvent(QWheelEvent *event)
+{
+    const int index = surfaceItemAt(event->position().toPoint());
+    if(index == -1) return false;
+
+    DockItem *item = m_items.at(index).item;
+    QWheelEvent mapped(event->position() - item->pos(), event->globalPosition(), event->pixelDelta(), event->angleDelta(),
+                       event->buttons(), event->modifiers(), event->phase(), event->inverted(), event->source());
+    mapped.setTimestamp(event->timestamp());
+    QCoreApplication::sendEvent(item, &mapped);
+    return mapped.isAccepted();
+}
+
+bool MainPanelControl::forwardToolTip(QHelpEvent *event)
+{
+    const int index = surfaceItemAt(event->pos());
+    if(index == -1) return false;
+
+    DockItem *item = m_items.at(index).item;
+    QHelpEvent mapped(QEvent::ToolTip, event->pos() - item->pos(), event->globalPos());
+    QCoreApplication::sendEvent(item, &mapped);
+    return mapped.isAccepted();
+}
+
+/**
+ * @brief MainPanelControl::forwardDragMove 统一绘制时外部拖放由面板接收，转发给鼠标下接受拖放的项，
+ * 没有项接受时返回 false，由面板按原来的逻辑处理
+ */
+bool MainPanelControl::forwardDragMove(QDragMoveEvent *event)
+{
+    const int index = surfaceItemAt(event->pos());
+    DockItem *item = index == -1 ? nullptr : m_items.at(index).item.data();
+
+    if(item != m_dropItem) {
+        setDropItem(nullptr);
+        if(item && item->acceptDrops()) {
+            QDragEnterEvent enter(event->pos() - item->pos(), event->possibleActions(), event->mimeData(), event->mouseButtons(), event->keyboardModifiers());
+            QCoreApplication::sendEvent(item, &enter);
+            if(enter.isAccepted()) {
+                // 拖到项上时面板的占位项不再保留，与子控件分别接收拖放时一致
+                clearPlaceholder();
+                m_dropItem = item;
+                event->setDropAction(enter.dropAction());
+                event->accept();
+                return true;
+            }
+        }
+    }
+
+    if(!m_dropItem) return false;
+
+    QDragMoveEvent move(event->pos() - m_dropItem->pos(), event->possibleActions(), event->mimeData(), event->mouseButtons(), event->keyboardModifiers());
+    move.setDropAction(event->dropAction());
+    move.setAccepted(event->isAccepted());
+    QCoreApplication::sendEvent(m_dropItem, &move);
+    event->setDropAction(move.dropAction());
+    event->setAccepted(move.isAccepted());
+    return true;
+}
+
+bool MainPanelControl::forwardDrop(QDropEvent *event)
+{
+    if(!m_dropItem) return false;
+
+    QDropEvent drop(event->pos() - m_dropItem->pos(), event->possibleActions(), event->mimeData(), event->mouseButtons(), event->keyboardModifiers());
+    drop.setDropAction(event->dropAction());
+    drop.setAccepted(event->isAccepted());
+    QCoreApplication::sendEvent(m_dropItem, &drop);
+    event->setDropAction(drop.dropAction());
+    event->setAccepted(drop.isAccepted());
+    m_dropItem = nullptr;
+    return true;
 }
 
-void MainPanelControl::addLastAreaItem(int index, QWidget *wdg)
+void MainPanelControl::setDropItem(DockItem *item)
 {
-    wdg->setFixedSize(DockItemManager::instance()->itemSize(), DockItemManager::instance()->itemSize());
-    m_lastAreaLayout->insertWidget(index, wdg);
+    if(m_dropItem == item) return;
+
+    if(m_dropItem) {
+        QDragLeaveEvent leave;
+        QCoreApplication::sendEvent(m_dropItem, &leave);
+    }
+    m_dropItem = item;
+}
+
+bool MainPanelControl::event(QEvent *event)
+{
+    switch (event->type()) {
+        case QEvent::ChildRemoved: {
+            // 拖入文件夹等操作会改变父对象，离开面板的项恢复自行绘制
+            QChildEvent *childEvent = static_cast<QChildEvent *>(event);
+            if(DockItem *item = qobject_cast<DockItem *>(childEvent->child())) {
+                removeItemFromList(item);
+                item->setPaintedBySurface(false);
+            }
+            break;
+        }
+        case QEvent::LayoutRequest:
+            m_layoutRequestPosted = false;
+            if(m_surfaceLayoutPending) layoutSurface();
+#ifdef ENABLE_PERF_TIMERS
+            // QBoxLayout 的布局在 event() 之前完成，统一绘制时在上面计算，之后结束计时
+            m_layoutProbe->finish();
+#endif
+            m_appAreaIndexDirty = true;
+            break;
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::MouseMove:
+            if(m_singleSurface && forwardMouseEvent(static_cast<QMouseEvent *>(event)))
+                return true;
+            break;
+        case QEvent::Wheel:
+            if(m_singleSurface && forwardWheelEvent(static_cast<QWheelEvent *>(event)))
+                return true;
+            break;
+        case QEvent::ToolTip:
+            if(m_singleSurface && forwardToolTip(static_cast<QHelpEvent *>(event)))
+                return true;
+            break;
+        case QEvent::Leave:
+            if(m_singleSurface && !m_pressedItem)
+                setHoverItem(nullptr, QPoint());
+            break;
+        default:
+            break;
+    }
+
+    return QWidget::event(event);
+}
+
+/**
+ * @brief MainPanelControl::paintEvent 统一绘制模式下按项列表中的位置依次绘制所有项，
+ * 项的控件本身隐藏，update() 时重绘的是这里对应的区域
+ */
+void MainPanelControl::paintEvent(QPaintEvent *event)
+{
+    if(!m_singleSurface) return QWidget::paintEvent(event);
+
+    if(m_surfaceLayoutPending) layoutSurface();
+
+    PERF_SCOPE("paint", "MainPanelControl");
+    const bool highlight = DockItemManager::instance()->isEnableHoverHighlight();
+    const QRect bounding = event->region().boundingRect();
+    const int end = isHorizontal() ? bounding.right() : bounding.bottom();
+    QPainter painter(this);
+    for(const PanelItem &entry : m_items) {
+        if((isHorizontal() ? entry.geometry.left() : entry.geometry.top()) > end)
+            break;
+        if(!entry.item || !event->region().intersects(entry.geometry))
+            continue;
+
+        DockItem *item = entry.item;
+        PERF_SCOPE("paint", item->metaObject()->className());
+        if(highlight && item == m_hoverItem) {
+            painter.drawPixmap(entry.geometry.topLeft(), item->lighterPixmap());
+            continue;
+        }
+
+        painter.save();
+        painter.translate(entry.geometry.topLeft());
+        painter.setClipRect(QRect(QPoint(0, 0), entry.geometry.size()));
+        item->paintItem(painter);
+        painter.restore();
+    }
 }
 
 void MainPanelControl::resizeEvent(QResizeEvent *event)
 {
+    PERF_SCOPE("resize", "MainPanelControl");
     resizeDockIcon();
+    invalidateItemLayout();
     // m_appAreaWidget->adjustSize();
     return QWidget::resizeEvent(event);
 }
@@ -267,11 +983,14 @@ void MainPanelControl::insertItem(int index, DockItem *item, bool animation)
                     removeAppAreaItem(item);
                     break;
                 case DockItem::Plugins:
-                    m_lastAreaLayout->removeWidget(item);
+                    removeAreaItem(LastArea, item);
                     break;
                 case DockItem::Window:
-                    m_windowAreaLayout->removeWidget(item);
-                    if(m_windowAreaLayout->isEmpty()) m_splitter->hide();
+                    removeAreaItem(WindowArea, item);
+                    if(areaCount(WindowArea) == 0) {
+                        m_splitter->hide();
+                        invalidateItemLayout();
+                    }
                     break;
                 default:
                     break;
@@ -289,7 +1008,7 @@ void MainPanelControl::insertItem(int index, DockItem *item, bool animation)
         case DockItem::App:
         case DockItem::Placeholder:
         case DockItem::DirApp:
-            addAppAreaItem(index ==-1 ? m_appAreaLayout->count() : index, item);
+            addAppAreaItem(index ==-1 ? areaCount(AppArea) : index, item);
             break;
         case DockItem::Window:
             addWindowAreaItem(index, item);
@@ -351,7 +1070,7 @@ bool MainPanelControl::eventFilter(QObject *watched, QEvent *event)
             const QPoint distance = mouseEvent->globalPos() - m_mousePressPos;
             const int disTime = QDateTime::currentMSecsSinceEpoch() - m_mousePressTime;
             if (distance.manhattanLength() >= QApplication::startDragDistance() && disTime >= 100 /*QApplication::startDragTime()*/) {
-                beforeIndex = m_appAreaLayout->indexOf(item);
+                beforeIndex = areaIndexOf(AppArea, item);
                 startDrag(item);
                 beforeIndex = -1;
                 return true;
@@ -375,80 +1094,85 @@ void MainPanelControl::dragEnterEvent(QDragEnterEvent *event) {
         event->ignore();
     else if (DockItemManager::instance()->appIsOnDock(DragmineData->data(m_draggingMimeKey)))
         event->ignore();
-    else event->accept(m_appAreaLayout->geometry());
+    else event->accept(areaGeometry(AppArea));
 
     if(event->isAccepted() == false && DragmineData->hasUrls()) {
         QList<QUrl> urls = DragmineData->urls();
         if(urls.size() == 1 && urls.first().isLocalFile()) {
             QFileInfo info(urls.first().toLocalFile());//TODO: add features
             if(info.exists() && info.isDir()) {
-                event->accept(m_lastAreaLayout->geometry() | m_splitter2->geometry());
+                event->accept(areaGeometry(LastArea) | m_splitter2->geometry());
                 m_draggingMimeKey.clear();
             }
         }
     }
+
+    if(!m_singleSurface) return;
+
+    // 统一绘制时各项不单独接收拖放，面板必须接受进入事件才能继续收到移动事件，再按位置转发给项或自己处理
+    m_dragAcceptedByPanel = event->isAccepted();
+    if(!m_dragAcceptedByPanel && !DragmineData->hasUrls()) return;
+
+    event->accept(QRect(event->pos(), QSize(1, 1)));
+    if(!forwardDragMove(event) && !m_dragAcceptedByPanel)
+        event->setDropAction(Qt::IgnoreAction);
 }
 
 void MainPanelControl::dragMoveEvent(QDragMoveEvent *event) {
+    if(m_singleSurface) {
+        if(forwardDragMove(event)) return;
+        if(!m_dragAcceptedByPanel) return event->ignore();
+        event->accept();
+    }
+
     if (m_placeholderItem.isNull())
         m_placeholderItem = new PlaceholderItem;
 
     if(m_draggingMimeKey.isEmpty()) {
-        if(m_lastAreaLayout->geometry().united(m_splitter2->geometry()).contains(event->pos())) {
-            if(m_lastAreaLayout->indexOf(m_placeholderItem) == -1) {
+        if(areaGeometry(LastArea).united(m_splitter2->geometry()).contains(event->pos())) {
+            if(areaIndexOf(LastArea, m_placeholderItem) == -1) {
                 const int width = DockItemManager::instance()->itemSize();
                 m_placeholderItem->setFixedSize(width-2, width-2);
-                m_lastAreaLayout->insertWidget(0, m_placeholderItem);
+                insertAreaItem(LastArea, 0, m_placeholderItem);
             }
         } else
-            m_lastAreaLayout->removeWidget(m_placeholderItem);
+            removeAreaItem(LastArea, m_placeholderItem);
     } else
         dropTargetItem(m_placeholderItem, event->pos());
 }
 
 void MainPanelControl::dropEvent(QDropEvent *event) {
+    if (m_singleSurface && forwardDrop(event)) {
+        clearPlaceholder();
+        return;
+    }
+
     if (m_placeholderItem) {
         QPoint point = event->pos();
         if(m_draggingMimeKey.isEmpty()) {
-            if(m_lastAreaLayout->geometry().contains(event->pos()))
+            if(areaGeometry(LastArea).contains(event->pos()))
                 emit folderAdded(event->mimeData()->urls().first().toLocalFile());
 
-            m_lastAreaLayout->removeWidget(m_placeholderItem);
+            removeAreaItem(LastArea, m_placeholderItem);
             m_placeholderItem->deleteLater();
         } else {
-            if(m_appAreaLayout->geometry().contains(point)) {
+            if(areaGeometry(AppArea).contains(point)) {
                 DirItem *targetItem = nullptr;
 
-                for (int i = 0; i < m_appAreaLayout->count(); ++i)
+                const int hit = appAreaItemAt(isHorizontal() ? point.x() : point.y());
+                if (hit != -1 && m_hitItems.at(hit) != m_placeholderItem && m_hitItems.at(hit)->itemType() == DockItem::DirApp)
                 {
-                    DockItem *dockItem = qobject_cast<DockItem *>(m_appAreaLayout->itemAt(i)->widget());
-                    if (!dockItem || dockItem == m_placeholderItem || dockItem->itemType() != DockItem::DirApp)
-                        continue;
-
+                    DockItem *dockItem = m_hitItems.at(hit);
                     QRect rect(dockItem->pos(), dockItem->size());
-
-                    if (isHorizontal())
-                    {
-                        if(qFabs(rect.center().x() - point.x()) < rect.width() / 4)
-                        {
-                            targetItem = qobject_cast<DirItem *>(dockItem);
-                            break;
-                        }
-                    }
-                    else
-                    {
-                        if(qFabs(rect.center().y() - point.y()) < rect.width() / 4)
-                        {
-                            targetItem = qobject_cast<DirItem *>(dockItem);
-                            break;
-                        }
-                    }
+                    const int distance = isHorizontal() ? qAbs(rect.center().x() - point.x()) : qAbs(rect.center().y() - point.y());
+                    if (distance < rect.width() / 4)
+                        targetItem = qobject_cast<DirItem *>(dockItem);
                 }
 
-                int index = m_appAreaLayout->indexOf(m_placeholderItem);
+                int index = areaIndexOf(AppArea, m_placeholderItem);
                 if(targetItem)
                 {
-                    index = m_appAreaLayout->indexOf(targetItem) + targetItem->currentCount();
+                    index = areaIndexOf(AppArea, targetItem) + targetItem->currentCount();
                     targetItem->addId(event->mimeData()->data(m_draggingMimeKey));
                 }
 
@@ -462,6 +1186,12 @@ void MainPanelControl::dropEvent(QDropEvent *event) {
 }
 
 void MainPanelControl::dragLeaveEvent(QDragLeaveEvent *event) {
+    setDropItem(nullptr);
+    clearPlaceholder();
+}
+
+void MainPanelControl::clearPlaceholder()
+{
     if (m_placeholderItem) {
         removeAppAreaItem(m_placeholderItem);
         m_placeholderItem->deleteLater();
@@ -471,7 +1201,7 @@ void MainPanelControl::dragLeaveEvent(QDragLeaveEvent *event) {
 void MainPanelControl::startDrag(DockItem *item)
 {
     item->update();
-    const QPixmap pixmap = item->grab();
+    const QPixmap pixmap = item->itemPixmap();
     appDrag = new AppDrag(item);
     connect(appDrag->appDragWidget(), &AppDragWidget::finished, this, [this, item](bool undock){
         if(undock && qobject_cast<AppItem*>(item))
@@ -497,181 +1227,151 @@ void MainPanelControl::dropTargetItem(DockItem *sourceItem, QPoint point)
 {
     static QPoint lastPos;
     const int width = DockItemManager::instance()->itemSize();
+    const int sourceIndex = appAreaIndexOf(sourceItem);
 
-    if(m_appAreaLayout->geometry().contains(point) == false) {
-        if(m_appAreaLayout->indexOf(sourceItem) == -1) {
-            sourceItem->setFixedSize(width * .1, width * .1);
+    const QRect appArea = areaGeometry(AppArea);
+    if(appArea.contains(point) == false) {
+        if(sourceIndex == -1) {
+            setItemSizeOnFrame(sourceItem, QSize(width * .1, width * .1));
             if(isHorizontal())
-                addAppAreaItem(point.x() < m_appAreaLayout->geometry().x() ? 0 : m_appAreaLayout->count(), sourceItem);
+                addAppAreaItem(point.x() < appArea.x() ? 0 : areaCount(AppArea), sourceItem);
             else
-                addAppAreaItem(point.y() < m_appAreaLayout->geometry().y() ? 0 : m_appAreaLayout->count(), sourceItem);
+                addAppAreaItem(point.y() < appArea.y() ? 0 : areaCount(AppArea), sourceItem);
         }
         return;
     }
-    if(m_appAreaLayout->isEmpty())
+    if(areaCount(AppArea) == 0)
         return addAppAreaItem(0, sourceItem);
-    if(m_appAreaLayout->count() == 1 && m_appAreaLayout->itemAt(0)->widget() == sourceItem)
+    if(areaCount(AppArea) == 1 && sourceIndex == 0)
         return;
 
-    const bool animation = DockItemManager::instance()->isEnableDragAnimation();
+    const bool horizontal = isHorizontal();
+    const int pos = horizontal ? point.x() : point.y();
+    const int hit = appAreaItemAt(pos);
+    if(hit == -1) {
+        lastPos = point;
+        return;
+    }
 
-    for (int i = 0; i < m_appAreaLayout->count(); ++i)
+    const bool animation = DockItemManager::instance()->isEnableDragAnimation();
+    DockItem *dockItem = m_hitItems.at(hit);
+    const int targetIndex = m_hitLayoutIndexes.at(hit);
+    const QRect rect = dockItem->geometry();
+    const int center = horizontal ? rect.center().x() : rect.center().y();
+    const int distance = qAbs(center - pos);
+    const int lastDistance = qAbs(center - (horizontal ? lastPos.x() : lastPos.y()));
+    const int snap = horizontal ? rect.width() / 4 : rect.width() / 5;
+    qreal ratio = 1;
+
+    if(sourceItem == dockItem)
     {
-        DockItem *dockItem = qobject_cast<DockItem *>(m_appAreaLayout->itemAt(i)->widget());
-        qreal ratio = 1;
-        QRect rect = dockItem->geometry();
-
-        if(isHorizontal())
+        if(animation) ratio = 1 - distance / (width * 1.0);
+    }
+    else if(distance < snap)
+    {
+        if(sourceIndex == -1)
         {
-            if(rect.left()-MODE_PADDING/2 <= point.x() && rect.right()+MODE_PADDING/2 >= point.x() ) {
-                if(sourceItem == dockItem)
-                {
-                    if(animation) ratio = 1 - (qFabs(rect.center().x() - point.x())) / ( width * 1.0);
-                }
-                else if(qFabs(rect.center().x() - point.x()) < rect.width()/4)
-                {
-                    // if(animation && sourceItem->itemType() != DockItem::DirApp && m_appAreaLayout->indexOf(sourceItem) > -1)
-                    // {
-                    //     removeAppAreaItem(sourceItem);
-                    //     sourceItem->setVisible(false);
-                    // }
-                    if(m_appAreaLayout->indexOf(sourceItem) == -1)
-                    {
-                        addAppAreaItem(m_appAreaLayout->indexOf(dockItem) + ( point.x() > rect.center().x() ? 1 : 0 ) , sourceItem);
-                        sourceItem->setVisible(true);
-                    }
-                    if(animation) ratio = .1;
-                }
-                else if (qFabs(rect.center().x() - point.x()) > rect.width()/4)
-                {
-                    if(qFabs(rect.center().x() - point.x()) > qFabs(rect.center().x() - lastPos.x()))
-                    {
-                        if(m_appAreaLayout->indexOf(sourceItem) == -1)
-                        {
-                            addAppAreaItem(m_appAreaLayout->indexOf(dockItem) + ( point.x() > rect.center().x() ? 1 : 0 ) , sourceItem);
-                            sourceItem->setVisible(true);
-                        }
-                        else //if(!animation || sourceItem->itemType() == DockItem::DirApp)
-                        {
-                            if(point.x() > rect.center().x())
-                            {
-                                if(m_appAreaLayout->indexOf(sourceItem) < m_appAreaLayout->indexOf(dockItem))
-                                {
-                                    removeAppAreaItem(sourceItem);
-                                    addAppAreaItem(m_appAreaLayout->indexOf(dockItem) + 1 , sourceItem);
-                                }
-                            }
-                            else if(point.x() < rect.center().x())
-                            {
-                                if(m_appAreaLayout->indexOf(sourceItem) > m_appAreaLayout->indexOf(dockItem))
-                                {
-                                    removeAppAreaItem(sourceItem);
-                                    addAppAreaItem(m_appAreaLayout->indexOf(dockItem) , sourceItem);
-                                }
-                            }
-                        }
-                    }
-                    if(animation) ratio = qMax(.1, qFabs(rect.center().x() - point.x()) / ( width * 1.0 ));
-                }
-
-                if(animation) sourceItem->setFixedSize(width * ratio, width * ratio);
-
-                lastPos = point;
-                return;
-            }
+            addAppAreaItem(targetIndex + (pos > center ? 1 : 0), sourceItem);
+            if(!m_singleSurface) sourceItem->setVisible(true);
         }
-        else
+        if(animation) ratio = .1;
+    }
+    else if(distance > snap)
+    {
+        if(distance > lastDistance)
         {
-            if(rect.top()-MODE_PADDING/2 <= point.y() && rect.bottom()+MODE_PADDING/2 >= point.y() ) {
-                if(sourceItem == dockItem)
-                {
-                    if(animation) ratio = 1 - qFabs(rect.center().y() - point.y()) / ( width / 1.0);
-                }
-                else if(qFabs(rect.center().y() - point.y()) < rect.width()/5)
-                {
-                    // if(animation && sourceItem->itemType() != DockItem::DirApp && m_appAreaLayout->indexOf(sourceItem) > -1)
-                    // {
-                    //     removeAppAreaItem(sourceItem);
-                    //     sourceItem->setVisible(false);
-                    // }
-                    if(m_appAreaLayout->indexOf(sourceItem) == -1)
-                    {
-                        addAppAreaItem(m_appAreaLayout->indexOf(dockItem) + ( point.y() > rect.center().y() ? 1 : 0 ), sourceItem);
-                        sourceItem->setVisible(true);
-                    }
-                    if(animation) ratio = .1;
-                }
-                else if (qFabs(rect.center().y() - point.y()) > rect.width()/5)
-                {
-                    if(qFabs(rect.center().y() - point.y()) > qFabs(rect.center().y() - lastPos.y()))
-                    {
-                        if(m_appAreaLayout->indexOf(sourceItem) == -1)
-                        {
-                            addAppAreaItem(m_appAreaLayout->indexOf(dockItem) + ( point.y() > rect.center().y() ? 1 : 0 ), sourceItem);
-                            sourceItem->setVisible(true);
-                        }
-                        else //if(!animation || sourceItem->itemType() == DockItem::DirApp)
-                        {
-                            if(point.y() > rect.center().y())
-                            {
-                                if(m_appAreaLayout->indexOf(sourceItem) < m_appAreaLayout->indexOf(dockItem))
-                                {
-                                    removeAppAreaItem(sourceItem);
-                                    addAppAreaItem(m_appAreaLayout->indexOf(dockItem) + 1 , sourceItem);
-                                }
-                            }
-                            else if(point.y() < rect.center().y())
-                            {
-                                if(m_appAreaLayout->indexOf(sourceItem) > m_appAreaLayout->indexOf(dockItem))
-                                {
-                                    removeAppAreaItem(sourceItem);
-                                    addAppAreaItem(m_appAreaLayout->indexOf(dockItem) , sourceItem);
-                                }
-                            }
-                        }
-                    }
-                    if(animation) ratio = qMax(.1, qFabs(rect.center().y() - point.y()) / ( width / 1.0 ));
-                }
-
-                if(animation) sourceItem->setFixedSize(width * ratio, width * ratio);
-
-                lastPos = point;
-                return;
+            if(sourceIndex == -1)
+            {
+                addAppAreaItem(targetIndex + (pos > center ? 1 : 0), sourceItem);
+                if(!m_singleSurface) sourceItem->setVisible(true);
+            }
+            else if((pos > center && sourceIndex < targetIndex) || (pos < center && sourceIndex > targetIndex))
+            {
+                // 源项在目标之前时，移除后目标前移一位，两种情况插入位置都是原来的 targetIndex
+                removeAppAreaItem(sourceItem);
+                addAppAreaItem(targetIndex, sourceItem);
             }
         }
+        if(animation) ratio = qMax(.1, distance / (width * 1.0));
     }
+
+    if(animation) setItemSizeOnFrame(sourceItem, QSize(width * ratio, width * ratio));
+
     lastPos = point;
 }
 
+/**
+ * @brief MainPanelControl::updateAppAreaIndex 每次布局后记录应用区各项沿任务栏方向的边界，
+ * 边界单调递增，拖拽时用二分查找定位鼠标下的项
+ */
+void MainPanelControl::updateAppAreaIndex()
+{
+    if(!m_appAreaIndexDirty) return;
+
+    m_hitItems.clear();
+    m_hitLayoutIndexes.clear();
+    m_hitStarts.clear();
+    m_hitEnds.clear();
+    m_layoutIndexes.clear();
+
+    if(m_surfaceLayoutPending) layoutSurface();
+
+    m_appAreaIndexDirty = false;
+    const bool horizontal = isHorizontal();
+    const int begin = areaBegin(AppArea);
+    for(int i = 0; i < areaCount(AppArea); ++i) {
+        DockItem *dockItem = m_items.at(begin + i).item;
+        m_layoutIndexes.insert(dockItem, i);
+
+        // 统一绘制时控件本身都是隐藏的
+        if(!dockItem || (!m_singleSurface && dockItem->isHidden()))
+            continue;
+
+        const QRect rect = itemGeometry(begin + i);
+        m_hitItems.append(dockItem);
+        m_hitLayoutIndexes.append(i);
+        m_hitStarts.append((horizontal ? rect.left() : rect.top()) - MODE_PADDING / 2);
+        m_hitEnds.append((horizontal ? rect.right() : rect.bottom()) + MODE_PADDING / 2);
+    }
+}
+
+int MainPanelControl::appAreaItemAt(int pos)
+{
+    updateAppAreaIndex();
+
+    const auto it = std::lower_bound(m_hitEnds.constBegin(), m_hitEnds.constEnd(), pos);
+    if(it == m_hitEnds.constEnd())
+        return -1;
+
+    const int hit = it - m_hitEnds.constBegin();
+    return m_hitStarts.at(hit) <= pos ? hit : -1;
+}
+
+int MainPanelControl::appAreaIndexOf(QWidget *widget)
+{
+    updateAppAreaIndex();
+    return m_layoutIndexes.value(widget, -1);
+}
+
 void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
 {
+    // 拖动过程中的尺寸变化按帧合并，放下前先全部应用
+    AnimationClock::instance()->flush();
+
     bool needUpdateDirApp = false;
     bool needUpdateWindowSize = false;
     DockItem *targetItem = nullptr;
 
-    if(sourceItem->itemType() == DockItem::App && m_appAreaLayout->geometry().contains(point))
+    if(sourceItem->itemType() == DockItem::App && areaGeometry(AppArea).contains(point))
     {
-        for (int i = 0; i < m_appAreaLayout->count(); ++i)
+        const int hit = appAreaItemAt(isHorizontal() ? point.x() : point.y());
+        if(hit != -1)
         {
-            DockItem *dockItem = qobject_cast<DockItem *>(m_appAreaLayout->itemAt(i)->widget());
+            DockItem *dockItem = m_hitItems.at(hit);
             QRect rect(dockItem->pos(), dockItem->size());
-            if (isHorizontal())
-            {
-                if(qFabs(rect.center().x() - point.x()) < rect.width() / 2 + MODE_PADDING/2) {
-                    if(qFabs(rect.center().x() - point.x()) < rect.width() / 4)
-                        targetItem = dockItem;
-                    break;
-                }
-            }
-            else
-            {
-                if(qFabs(rect.center().y() - point.y()) < rect.width() / 2 + MODE_PADDING/2)
-                {
-                    if(qFabs(rect.center().y() - point.y()) < rect.width() / 4)
-                        targetItem = dockItem;
-                    break;
-                }
-            }
+            const int distance = isHorizontal() ? qAbs(rect.center().x() - point.x()) : qAbs(rect.center().y() - point.y());
+            if(distance < rect.width() / 4)
+                targetItem = dockItem;
         }
         if(targetItem == sourceItem) targetItem = nullptr;
     }
@@ -705,7 +1405,7 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
         {
             replaceItem = qobject_cast<AppItem*>(targetItem);
 
-            int currentIndex = m_appAreaLayout->indexOf(targetItem);
+            int currentIndex = areaIndexOf(AppArea, targetItem);
             if(!sourceDir)
             {
                 replaceIndex = appList.indexOf(replaceItem);
@@ -737,15 +1437,15 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
     }
     else
     {
-        const int afterIndex = m_appAreaLayout->indexOf(sourceItem);
-        sourceItem->setFixedSize(DockItemManager::instance()->itemSize(), DockItemManager::instance()->itemSize());
+        const int afterIndex = areaIndexOf(AppArea, sourceItem);
+        setItemSize(sourceItem, QSize(DockItemManager::instance()->itemSize(), DockItemManager::instance()->itemSize()));
 
         DockItem *target = nullptr;
         if(beforeIndex == -1)
         {
             AppItem *source = qobject_cast<AppItem *>(sourceItem);
             DirItem *sourceDir = source->getDirItem();
-            const int dirIndex = m_appAreaLayout->indexOf(sourceDir);
+            const int dirIndex = areaIndexOf(AppArea, sourceDir);
 
             sourceDir->removeItem(source);
             needUpdateWindowSize = true;
@@ -755,7 +1455,7 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
                 int nextIndex = afterIndex + 1;
                 while(!target && dirIndex >= nextIndex)
                 {
-                    target = qobject_cast<DockItem *>(m_appAreaLayout->itemAt(nextIndex++)->widget());
+                    target = areaItemAt(AppArea, nextIndex++);
                     if(target->itemType() == DockItem::DirApp)
                         target = qobject_cast<DirItem *>(target)->firstItem();
                 }
@@ -765,7 +1465,7 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
                 int prevIndex = afterIndex - 1;
                 while(!target && prevIndex >=0)
                 {
-                    target = qobject_cast<DockItem *>(m_appAreaLayout->itemAt(prevIndex--)->widget());
+                    target = areaItemAt(AppArea, prevIndex--);
                     if(target->itemType() == DockItem::DirApp)
                         target = qobject_cast<DirItem *>(target)->lastItem();
                 }
@@ -773,7 +1473,7 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
         }
         else if(beforeIndex != afterIndex)
         {
-            target = qobject_cast<DockItem *>(afterIndex > beforeIndex ? m_appAreaLayout->itemAt(afterIndex - 1)->widget() : m_appAreaLayout->itemAt(afterIndex + 1)->widget());
+            target = areaItemAt(AppArea, afterIndex > beforeIndex ? afterIndex - 1 : afterIndex + 1);
             if (target->itemType() == DockItem::DirApp)
             {
                 if(afterIndex < beforeIndex)
@@ -794,9 +1494,9 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
     }
 
     if(needUpdateDirApp == false)
-        for(int i=0,len=m_appAreaLayout->count(); i<len; i++)
+        for(int i=0,len=areaCount(AppArea); i<len; i++)
         {
-            auto item = qobject_cast<DirItem*>(m_appAreaLayout->itemAt(i)->widget());
+            auto item = qobject_cast<DirItem*>(areaItemAt(AppArea, i));
             if(item && item->isEmpty())
             {
                 needUpdateDirApp = true;
@@ -811,9 +1511,11 @@ void MainPanelControl::handleDragDrop(DockItem *sourceItem, QPoint point)
 
 void MainPanelControl::resizeDockIcon()
 {
-    if(m_fixedAreaLayout->count() == 0) return;
+    PERF_SCOPE("resize", "resizeDockIcon");
+
+    if(areaCount(FixedArea) == 0) return;
 
-    const int oldSize = m_fixedAreaLayout->itemAt(0)->widget()->width();
+    const int oldSize = areaItemAt(FixedArea, 0)->width();
     int size;
 
     if (isHorizontal()) {
@@ -829,15 +1531,9 @@ void MainPanelControl::resizeDockIcon()
     }
 
     QSize s(size, size);
-    if(m_fixedAreaLayout->count() > 0)
-        m_fixedAreaLayout->itemAt(0)->widget()->setFixedSize(s);
-
-    for (int i = 0; i < m_appAreaLayout->count(); ++ i)
-        m_appAreaLayout->itemAt(i)->widget()->setFixedSize(s);
-
-    for(int i(0); i < m_windowAreaLayout->count(); ++i)
-        m_windowAreaLayout->itemAt(i)->widget()->setFixedSize(s);
+    for(const PanelItem &entry : m_items)
+        if(entry.item)
+            entry.item->setFixedSize(s);
 
-    for(int i(0); i < m_lastAreaLayout->count(); ++i)
-        m_lastAreaLayout->itemAt(i)->widget()->setFixedSize(s);
+    invalidateItemLayout();
 }
\ No newline at end of file
@@ -26,29 +26,45 @@
 
 #include <QWidget>
 #include <QBoxLayout>
+#include <QVector>
+#include <QHash>
+#include <QPointer>
 
 using namespace Dock;
 
 class DockItem;
 class AppItem;
+class PerfLayoutProbe;
 class PlaceholderItem;
 class SplitterWidget;
+class QHelpEvent;
 class MainPanelControl : public QWidget
 {
     Q_OBJECT
 public:
+    enum Area {
+        FixedArea,
+        AppArea,
+        WindowArea,
+        LastArea
+    };
+
     MainPanelControl(QWidget *parent = 0);
     ~MainPanelControl();
 
-    void addFixedAreaItem(int index, QWidget *wdg);
-    void addAppAreaItem(int index, QWidget *wdg);
+    void addFixedAreaItem(int index, DockItem *item);
+    void addAppAreaItem(int index, DockItem *item);
     void removeFixedAreaItem(QWidget *wdg);
     void removeAppAreaItem(QWidget *wdg);
-    void addWindowAreaItem(int index, QWidget *wdg);
-    void addLastAreaItem(int index, QWidget *wdg);
+    void addWindowAreaItem(int index, DockItem *item);
+    void addLastAreaItem(int index, DockItem *item);
+    void setItemSize(DockItem *item, const QSize &size);
     void setPositonValue(Position position);
+    void setSingleSurface(bool enable);
 
 protected:
+    bool event(QEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
     bool eventFilter(QObject *watched, QEvent *event) override;
     void dragEnterEvent(QDragEnterEvent *event) override;
@@ -66,6 +82,34 @@ private:
     void handleDragDrop(DockItem *sourceItem, QPoint point);
     inline bool isHorizontal() const { return m_position == Bottom || m_position == Top; }
     void resizeDockIcon();
+    void updateAppAreaIndex();
+    int appAreaItemAt(int pos);
+    int appAreaIndexOf(QWidget *widget);
+
+    void setItemSizeOnFrame(DockItem *item, const QSize &size);
+    QBoxLayout *areaLayout(Area area) const;
+    int areaBegin(Area area) const;
+    int areaCount(Area area) const { return m_areaCounts[area]; }
+    DockItem *areaItemAt(Area area, int index) const;
+    int areaIndexOf(Area area, const QWidget *item) const;
+    QRect areaGeometry(Area area);
+    void insertAreaItem(Area area, int index, DockItem *item);
+    void removeAreaItem(Area area, const QWidget *item);
+    void removeItemFromList(const QWidget *item);
+    void removeDestroyedItems();
+    QRect itemGeometry(int index) const;
+    void invalidateItemLayout();
+
+    void layoutSurface();
+    int surfaceItemAt(const QPoint &pos);
+    void setHoverItem(DockItem *item, const QPoint &pos);
+    bool forwardMouseEvent(QMouseEvent *event);
+    bool forwardWheelEvent(QWheelEvent *event);
+    bool forwardToolTip(QHelpEvent *event);
+    bool forwardDragMove(QDragMoveEvent *event);
+    bool forwardDrop(QDropEvent *event);
+    void setDropItem(DockItem *item);
+    void clearPlaceholder();
 
 public slots:
     void insertItem(const int index, DockItem *item, bool animation = true);
@@ -81,6 +125,12 @@ signals:
     void requestResizeDockSize(int offset, bool dragging);
 
 private:
+    struct PanelItem {
+        QPointer<DockItem> item;
+        Area area;
+        QRect geometry;     // 统一绘制时由 layoutSurface() 计算的面板坐标
+    };
+
     QBoxLayout *m_fixedAreaLayout;
     QBoxLayout *m_appAreaLayout;
     QBoxLayout *m_windowAreaLayout;
@@ -92,8 +142,33 @@ private:
     Position m_position;
     QPointer<PlaceholderItem> m_placeholderItem;
     QString m_draggingMimeKey;
+    bool m_singleSurface;   // 所有 DockItem 由面板布局并在一次绘制中画出，子控件隐藏，事件由面板转发
+
+    // 所有区域的项按显示顺序排列，同一区域的项相邻；非统一绘制时各区域的 QBoxLayout 与之保持一致
+    QVector<PanelItem> m_items;
+    int m_areaCounts[LastArea + 1];
+    QRect m_areaRects[LastArea + 1];
+    bool m_surfaceLayoutPending;
+    bool m_layoutRequestPosted;
+    QPointer<DockItem> m_hoverItem;
+    QPointer<DockItem> m_pressedItem;
+    QPointer<DockItem> m_dropItem;
+    bool m_dragAcceptedByPanel;
+
+    // 拖拽命中测试用的索引，布局变化后重建
+    bool m_appAreaIndexDirty;
+    QVector<DockItem *> m_hitItems;
+    QVector<int> m_hitLayoutIndexes;
+    QVector<int> m_hitStarts;
+    QVector<int> m_hitEnds;
+    QHash<QWidget *, int> m_layoutIndexes;
+
+#ifdef ENABLE_PERF_TIMERS
+    PerfLayoutProbe *m_layoutProbe;
+#endif
 
     friend class SplitterWidget;
+    friend class MainPanelAccessible;
 };
 
 #endif // MAINPANELCONTROL_H
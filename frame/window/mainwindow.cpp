@@ -26,10 +26,13 @@
 #include "xcb/xcb_misc.h"
 #include "util/multiscreenworker.h"
 #include "util/menuworker.h"
+#include "item/components/appeffect.h"
+#include "util/perfstatistics.h"
 
 #include <DWindowManagerHelper>
 #include <QEvent>
 #include <QHBoxLayout>
+#include <QLabel>
 
 #define MAINWINDOW_MAX_SIZE       DOCK_MAX_SIZE
 #define MAINWINDOW_MIN_SIZE       (30)
@@ -37,10 +40,15 @@
 MainWindow::MainWindow(QWidget *parent) : DBlurEffectWidget(parent)
     , m_mainPanel(new MainPanelControl(this))
     , m_multiScreenWorker(new MultiScreenWorker(this))
+    , m_snapshot(new QLabel(this))
     , m_platformWindowHandle(this)
 {
     setWindowFlag(Qt::WindowDoesNotAcceptFocus);
 
+    m_snapshot->setAlignment(Qt::AlignCenter);
+    m_snapshot->setAttribute(Qt::WA_TransparentForMouseEvents);
+    m_snapshot->hide();
+
     QHBoxLayout *layout = new QHBoxLayout(this);
     layout->setMargin(0);
     layout->addWidget(m_mainPanel);
@@ -71,6 +79,8 @@ void MainWindow::launch()
 
         DockItemManager::instance()->reloadAppItems();
         m_multiScreenWorker->initShow();
+
+        AppEffect::preload();
     });
 }
 
@@ -111,13 +121,77 @@ void MainWindow::initConnections()
     });
 }
 
+/**
+ * @brief MainWindow::setSnapshotMode 显示隐藏和尺寸动画期间用面板截图代替实际的控件，
+ * 动画的每一帧不再重新布局和绘制应用图标，动画结束后切回实际控件并只布局一次
+ */
+void MainWindow::setSnapshotMode(bool enable)
+{
+    if (enable != m_snapshot->isHidden())
+        return;
+
+    if (enable) {
+        // 切换位置后布局请求可能还没处理，截图前先完成布局
+        layout()->activate();
+        if (m_mainPanel->layout())
+            m_mainPanel->layout()->activate();
+
+        m_snapshot->setPixmap(m_mainPanel->grab());
+        m_snapshot->setGeometry(rect());
+        m_snapshot->raise();
+        m_snapshot->show();
+
+        layout()->setEnabled(false);
+        m_mainPanel->setUpdatesEnabled(false);
+    } else {
+        m_snapshot->hide();
+        m_snapshot->setPixmap(QPixmap());
+
+        layout()->setEnabled(true);
+        layout()->activate();
+        m_mainPanel->setUpdatesEnabled(true);
+
+        emit DWindowManagerHelper::instance()->windowManagerChanged();
+    }
+}
+
+/**
+ * @brief MainWindow::event 窗口及子控件在 UpdateRequest 中完成绘制和刷新，之后通知动画统计这一帧的耗时
+ */
+bool MainWindow::event(QEvent *event)
+{
+    const bool ret = DBlurEffectWidget::event(event);
+
+    if (event->type() == QEvent::UpdateRequest)
+        emit framePainted();
+
+    return ret;
+}
+
 void MainWindow::moveEvent(QMoveEvent *event) {
+    PERF_SCOPE("animation", "MainWindowMove");
+
     DBlurEffectWidget::moveEvent(event);
-    emit DWindowManagerHelper::instance()->windowManagerChanged();
+
+    // 动画期间每一帧都会移动窗口，结束时再通知一次
+    if (m_snapshot->isHidden())
+        emit DWindowManagerHelper::instance()->windowManagerChanged();
+}
+
+void MainWindow::resizeEvent(QResizeEvent *event)
+{
+    PERF_SCOPE("animation", "MainWindowResize");
+
+    DBlurEffectWidget::resizeEvent(event);
+
+    if (!m_snapshot->isHidden())
+        m_snapshot->setGeometry(rect());
 }
 
 void MainWindow::resizeDock(int offset, bool dragging)
 {
+    PERF_SCOPE("resize", "MainWindow");
+
     offset = qBound(MAINWINDOW_MIN_SIZE, offset, MAINWINDOW_MAX_SIZE);
 
     if(dragging)
@@ -32,6 +32,7 @@
 
 DWIDGET_USE_NAMESPACE
 
+class QLabel;
 class MainPanelControl;
 class MultiScreenWorker;
 
@@ -42,6 +43,7 @@ class MainWindow : public DBlurEffectWidget
 public:
     explicit MainWindow(QWidget *parent = nullptr);
     inline MainPanelControl *panel() { return m_mainPanel; }
+    void setSnapshotMode(bool enable);
     friend class MainPanelControl;
 
 public slots:
@@ -52,14 +54,18 @@ public slots:
 
 protected:
     void initConnections();
+    bool event(QEvent *event) override;
     void moveEvent(QMoveEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
 
 signals:
     void geometryChanged(QRect rect);
+    void framePainted();
 
 private:
     MainPanelControl *m_mainPanel;
     MultiScreenWorker *m_multiScreenWorker;
+    QLabel *m_snapshot;                 // 显示隐藏动画期间代替面板显示的截图
 
     DPlatformWindowHandle m_platformWindowHandle;
 };
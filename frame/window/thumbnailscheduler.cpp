@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "thumbnailscheduler.h"
+#include "../item/WindowItem.h"
+#include "../taskmanager/taskmanager.h"
+#include "../util/thumbnailcache.h"
+
+#include <QTimer>
+
+#define DEFAULT_CAPTURES_PER_SECOND 2
+// 普通窗口的刷新间隔，内容不变时翻倍，最长 MAX_REFRESH_INTERVAL
+#define REFRESH_INTERVAL        10000
+#define MAX_REFRESH_INTERVAL    80000
+// 鼠标下的窗口的刷新间隔
+#define HOVER_REFRESH_INTERVAL  2000
+
+ThumbnailScheduler::ThumbnailScheduler(QObject *parent)
+    : QObject(parent)
+    , m_tickTimer(new QTimer(this))
+    , m_paused(TaskManager::instance()->getHideState() == HideState::Hide)
+    , m_refreshCount(0)
+    , m_skippedMinimized(0)
+    , m_sampleTime(0)
+    , m_sampleCaptures(0)
+    , m_sampleBytes(0)
+    , m_capturesPerSecond(0)
+    , m_bytesPerSecond(0)
+{
+    m_clock.start();
+
+    m_tickTimer->setInterval(1000 / DEFAULT_CAPTURES_PER_SECOND);
+    connect(m_tickTimer, &QTimer::timeout, this, &ThumbnailScheduler::onTick);
+
+    connect(TaskManager::instance(), &TaskManager::hideStateChanged, this, &ThumbnailScheduler::onHideStateChanged);
+    connect(ThumbnailCache::instance(), &ThumbnailCache::thumbnailChanged, this, [this](const WId wid) {
+        onThumbnailChanged(wid, true);
+    });
+    connect(ThumbnailCache::instance(), &ThumbnailCache::thumbnailUnchanged, this, [this](const WId wid) {
+        onThumbnailChanged(wid, false);
+    });
+}
+
+void ThumbnailScheduler::addItem(WindowItem *item)
+{
+    // 新加入的窗口视为已经到期，下一个时间片就会刷新
+    m_items.insert(item, State { -REFRESH_INTERVAL, REFRESH_INTERVAL });
+    // 窗口项销毁时自行移除，不需要窗口项在析构时回头访问 DockItemManager
+    connect(item, &QObject::destroyed, this, [this, item] { removeItem(item); });
+    updateTimer();
+}
+
+void ThumbnailScheduler::removeItem(WindowItem *item)
+{
+    m_items.remove(item);
+    updateTimer();
+}
+
+void ThumbnailScheduler::setCapturesPerSecond(int count)
+{
+    m_tickTimer->setInterval(1000 / qBound(1, count, 60));
+}
+
+QVariantMap ThumbnailScheduler::statistics() const
+{
+    QVariantMap result;
+    result.insert("items", m_items.size());
+    result.insert("paused", m_paused);
+    result.insert("refreshes", m_refreshCount);
+    result.insert("skippedMinimized", m_skippedMinimized);
+    result.insert("captures", SnapshotCapturer::instance()->captureCount());
+    result.insert("capturedBytes", SnapshotCapturer::instance()->capturedBytes());
+    result.insert("capturesPerSecond", m_capturesPerSecond);
+    result.insert("bytesPerSecond", m_bytesPerSecond);
+    return result;
+}
+
+/**
+ * @brief ThumbnailScheduler::onTick 每个时间片最多刷新一个窗口：
+ * 鼠标下的窗口超过 HOVER_REFRESH_INTERVAL 时优先，否则选到期最久的窗口
+ */
+void ThumbnailScheduler::onTick()
+{
+    const qint64 now = m_clock.elapsed();
+
+    if (now - m_sampleTime >= 1000) {
+        const quint64 captures = SnapshotCapturer::instance()->captureCount();
+        const quint64 bytes = SnapshotCapturer::instance()->capturedBytes();
+        const qreal seconds = (now - m_sampleTime) / 1000.0;
+        m_capturesPerSecond = (captures - m_sampleCaptures) / seconds;
+        m_bytesPerSecond = (bytes - m_sampleBytes) / seconds;
+        m_sampleTime = now;
+        m_sampleCaptures = captures;
+        m_sampleBytes = bytes;
+    }
+
+    WindowItem *next = nullptr;
+    qint64 nextOverdue = 0;
+    for (auto it = m_items.begin(); it != m_items.end(); ++it) {
+        WindowItem *item = it.key();
+        if (!item->isVisibleOnDock() || !item->window()->isVisible())
+            continue;
+
+        const qint64 age = now - it->lastRefresh;
+        if (item->underMouse() && age >= HOVER_REFRESH_INTERVAL) {
+            next = item;
+            break;
+        }
+
+        const qint64 overdue = age - it->interval;
+        if (overdue < 0 || (next && overdue <= nextOverdue))
+            continue;
+
+        if (item->isMinimized()) {
+            // 最小化的窗口截不到新内容，推迟到下一个周期再检查
+            it->lastRefresh = now;
+            ++m_skippedMinimized;
+            continue;
+        }
+
+        next = item;
+        nextOverdue = overdue;
+    }
+
+    if (!next)
+        return;
+
+    m_items[next].lastRefresh = now;
+    ++m_refreshCount;
+    next->fetchSnapshot();
+}
+
+void ThumbnailScheduler::onHideStateChanged(int state)
+{
+    m_paused = state == HideState::Hide;
+    updateTimer();
+}
+
+void ThumbnailScheduler::onThumbnailChanged(const WId wid, bool changed)
+{
+    for (auto it = m_items.begin(); it != m_items.end(); ++it) {
+        if (it.key()->wid() != wid)
+            continue;
+
+        it->interval = changed ? REFRESH_INTERVAL : qMin(it->interval * 2, MAX_REFRESH_INTERVAL);
+    }
+}
+
+void ThumbnailScheduler::updateTimer()
+{
+    if (!m_paused && !m_items.isEmpty()) {
+        if (!m_tickTimer->isActive())
+            m_tickTimer->start();
+        return;
+    }
+
+    m_tickTimer->stop();
+    m_capturesPerSecond = 0;
+    m_bytesPerSecond = 0;
+}
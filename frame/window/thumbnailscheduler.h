@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#ifndef THUMBNAILSCHEDULER_H
+#define THUMBNAILSCHEDULER_H
+
+#include <QObject>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QVariantMap>
+#include <QWidget>
+
+class QTimer;
+class WindowItem;
+
+/**
+ * @brief The ThumbnailScheduler class
+ * 统一刷新任务栏上窗口项的缩略图：按每秒截图预算把刷新分散到各个时间片，每次只刷新一个窗口，
+ * 鼠标下的窗口优先。任务栏隐藏时暂停，最小化的窗口跳过，内容没有变化的窗口逐步降低刷新频率。
+ */
+class ThumbnailScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ThumbnailScheduler(QObject *parent = nullptr);
+
+    void addItem(WindowItem *item);
+    void removeItem(WindowItem *item);
+
+    void setCapturesPerSecond(int count);
+    QVariantMap statistics() const;
+
+private:
+    void onTick();
+    void onHideStateChanged(int state);
+    void onThumbnailChanged(const WId wid, bool changed);
+    void updateTimer();
+
+private:
+    struct State {
+        qint64 lastRefresh;
+        int interval;
+    };
+
+    QTimer *m_tickTimer;
+    QElapsedTimer m_clock;
+    QHash<WindowItem *, State> m_items;
+    bool m_paused;
+
+    quint64 m_refreshCount;
+    quint64 m_skippedMinimized;
+
+    // 每秒截图数和字节数的采样
+    qint64 m_sampleTime;
+    quint64 m_sampleCaptures;
+    quint64 m_sampleBytes;
+    qreal m_capturesPerSecond;
+    qreal m_bytesPerSecond;
+};
+
+#endif // THUMBNAILSCHEDULER_H
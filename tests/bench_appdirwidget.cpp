@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "item/appitem.h"
+#include "item/components/AppDirWidget.h"
+#include "taskmanager/appinfo.h"
+#include "taskmanager/entry.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QApplication>
+#include <QFile>
+#include <QLayout>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+
+namespace {
+
+const int AppCount = 50;
+AppDirWidget *folder = nullptr;
+
+// 50 个合成的 desktop 文件对应的应用，放进同一个集合
+void createFolder(const QString &path)
+{
+    folder = new AppDirWidget("bench");
+    for (int i = 0; i < AppCount; ++i) {
+        const QString fileName = QString("%1/bench-app-%2.desktop").arg(path).arg(i);
+        QFile file(fileName);
+        file.open(QIODevice::WriteOnly);
+        file.write(QString("[Desktop Entry]\nType=Application\nName=Bench %1\nExec=true\nIcon=application-x-executable\n")
+                   .arg(i).toUtf8());
+        file.close();
+
+        Entry *entry = new Entry(nullptr, new AppInfo(fileName), QString("bench-app-%1").arg(i));
+        folder->addAppItem(new AppItem(entry));
+    }
+}
+
+// 打开集合弹窗：布局并绘制第一帧
+void openFolder(benchmark::State &state)
+{
+    for (auto _ : state) {
+        folder->show();
+        folder->layout()->activate();
+        folder->repaint();
+
+        state.PauseTiming();
+        folder->hide();
+        QApplication::processEvents();
+        state.ResumeTiming();
+    }
+}
+
+// 拖动一个应用到另一格并重新布局，distance 为移动跨过的格数
+void reorder(benchmark::State &state)
+{
+    const int distance = int(state.range(0));
+
+    folder->show();
+    QApplication::processEvents();
+
+    bool back = false;
+    for (auto _ : state) {
+        if (back)
+            folder->moveAppItem(distance, 0);
+        else
+            folder->moveAppItem(0, distance);
+        back = !back;
+        folder->layout()->activate();
+    }
+
+    folder->hide();
+    QApplication::processEvents();
+}
+
+} // namespace
+
+BENCHMARK(openFolder)->Unit(benchmark::kMicrosecond);
+BENCHMARK(reorder)->Arg(1)->Arg(4)->Arg(AppCount - 1)->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char **argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QStandardPaths::setTestModeEnabled(true);
+    QApplication app(argc, argv);
+
+    QTemporaryDir dir;
+    createFolder(dir.path());
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+
+    delete folder;
+    return 0;
+}
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "item/components/foldermodel.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QApplication>
+#include <QDir>
+#include <QFile>
+#include <QListView>
+#include <QTemporaryDir>
+
+namespace {
+
+const int FileCount = 5000;
+QString folderPath;
+
+// 5000 个常见类型的文件，夹杂少量子目录
+void createFolder(const QString &path)
+{
+    static const char *suffixes[] = { "txt", "png", "jpg", "pdf", "cpp", "mp3", "mp4", "tar.gz", "docx", "desktop" };
+
+    QDir dir(path);
+    for (int i = 0; i < FileCount; ++i) {
+        const QString name = QString("file-%1.%2").arg(i, 5, 10, QChar('0')).arg(suffixes[i % 10]);
+        if (i % 100 == 0) {
+            dir.mkdir(name);
+            continue;
+        }
+        QFile file(dir.filePath(name));
+        file.open(QIODevice::WriteOnly);
+    }
+}
+
+void scanCold(benchmark::State &state)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(FolderModel::scan(folderPath, {}));
+}
+
+// 重新扫描时复用上次解析的图标名
+void scanWarm(benchmark::State &state)
+{
+    FolderModel model(folderPath);
+    model.update(FolderModel::scan(folderPath, {}));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(FolderModel::scan(folderPath, model.known()));
+}
+
+void populate(benchmark::State &state)
+{
+    const QVector<FolderEntry> entries = FolderModel::scan(folderPath, {});
+
+    for (auto _ : state) {
+        FolderModel model(folderPath);
+        model.update(entries);
+        benchmark::DoNotOptimize(model.rowCount());
+    }
+}
+
+// 一个文件被删除、另一个文件被创建后的增量更新
+void updateOneChange(benchmark::State &state)
+{
+    const QVector<FolderEntry> entries = FolderModel::scan(folderPath, {});
+    QVector<FolderEntry> changed = entries;
+    changed.remove(FileCount / 2);
+    changed.insert(FileCount / 4, FolderEntry{ "file-01250.new", "text-plain", "text-x-generic" });
+
+    FolderModel model(folderPath);
+    model.update(entries);
+
+    bool flip = false;
+    for (auto _ : state) {
+        model.update(flip ? entries : changed);
+        flip = !flip;
+    }
+}
+
+// 打开弹窗：图标模式列表视图布局并绘制第一帧
+void openView(benchmark::State &state)
+{
+    FolderModel model(folderPath);
+    model.update(FolderModel::scan(folderPath, {}));
+
+    for (auto _ : state) {
+        QListView view;
+        view.setViewMode(QListView::IconMode);
+        view.setFlow(QListView::LeftToRight);
+        view.setResizeMode(QListView::Adjust);
+        view.setUniformItemSizes(true);
+        view.setSpacing(30);
+        view.setModel(&model);
+        view.resize(560, 400);
+        view.show();
+        QApplication::processEvents();
+        view.repaint();
+    }
+}
+
+} // namespace
+
+BENCHMARK(scanCold)->Unit(benchmark::kMillisecond);
+BENCHMARK(scanWarm)->Unit(benchmark::kMillisecond);
+BENCHMARK(populate)->Unit(benchmark::kMillisecond);
+BENCHMARK(updateOneChange)->Unit(benchmark::kMicrosecond);
+BENCHMARK(openView)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char **argv)
+{
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    QTemporaryDir dir;
+    folderPath = dir.path();
+    createFolder(folderPath);
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "item/dockitem.h"
+#include "window/mainpanelcontrol.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QApplication>
+#include <QIcon>
+#include <QPainter>
+#include <QStandardPaths>
+#include <QVector>
+
+namespace {
+
+class BenchItem : public DockItem
+{
+public:
+    explicit BenchItem(const QIcon &icon)
+    {
+        m_icon = icon;
+    }
+
+    ItemType itemType() const override { return App; }
+};
+
+QIcon benchIcon(int index)
+{
+    QPixmap pixmap(128, 128);
+    pixmap.fill(Qt::transparent);
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setBrush(QColor::fromHsv(index * 37 % 360, 200, 220));
+    painter.drawRoundedRect(pixmap.rect().adjusted(8, 8, -8, -8), 24, 24);
+    return QIcon(pixmap);
+}
+
+QVector<DockItem *> setupPanel(MainPanelControl &panel, int count, bool singleSurface)
+{
+    QVector<DockItem *> items;
+    panel.setPositonValue(Bottom);
+    panel.setSingleSurface(singleSurface);
+    for (int i = 0; i < count; ++i) {
+        items.append(new BenchItem(benchIcon(i)));
+        panel.addAppAreaItem(i, items.last());
+    }
+    panel.resize(count * 60 + 200, 60);
+    panel.show();
+    QApplication::processEvents();
+    return items;
+}
+
+// 一帧：整个任务栏面板同步重绘一次，对比每个子控件各自绘制和面板统一绘制
+void paintPanel(benchmark::State &state, bool singleSurface)
+{
+    const int count = int(state.range(0));
+
+    MainPanelControl panel;
+    setupPanel(panel, count, singleSurface);
+
+    for (auto _ : state)
+        panel.repaint();
+
+    state.counters["items"] = count;
+}
+
+// 一帧拖拽：被拖动的项改变尺寸，之后的项全部移位，处理这一帧的布局请求和重绘。
+// 对比子控件加 QBoxLayout 和面板按项列表统一布局、统一绘制
+void dragFrame(benchmark::State &state, bool singleSurface)
+{
+    const int count = int(state.range(0));
+
+    MainPanelControl panel;
+    const QVector<DockItem *> items = setupPanel(panel, count, singleSurface);
+    DockItem *source = items.at(count / 2);
+
+    bool shrink = true;
+    for (auto _ : state) {
+        panel.setItemSize(source, shrink ? QSize(6, 6) : QSize(58, 58));
+        shrink = !shrink;
+        // LayoutRequest 布局移位后投递 UpdateRequest，一并处理完
+        QApplication::sendPostedEvents();
+    }
+
+    state.counters["items"] = count;
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(paintPanel, perItem, false)->RangeMultiplier(2)->Range(8, 128)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(paintPanel, singleSurface, true)->RangeMultiplier(2)->Range(8, 128)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dragFrame, perItem, false)->RangeMultiplier(2)->Range(8, 128)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(dragFrame, singleSurface, true)->RangeMultiplier(2)->Range(8, 128)->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char **argv)
+{
+    // 不依赖显示服务，也不改动用户的 setting.ini
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+    QStandardPaths::setTestModeEnabled(true);
+    QApplication app(argc, argv);
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
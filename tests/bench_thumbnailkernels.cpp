@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "thumbnailkernels.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace ThumbnailKernels;
+
+namespace {
+
+// 4K 截图的一行缩小到一半
+void halveRows(benchmark::State &state, HalveRowFunc kernel)
+{
+    const int width = 3840;
+    std::mt19937 random(1);
+    std::vector<uint32_t> r0(width), r1(width), out(width / 2);
+    for (int i = 0; i < width; ++i) {
+        r0[i] = random();
+        r1[i] = random();
+    }
+
+    for (auto _ : state) {
+        kernel(r0.data(), r1.data(), out.data(), 0, width / 2);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * int64_t(width) * 2 * 4);
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(halveRows, scalar, halveRowScalar);
+#if defined(__SSE2__)
+BENCHMARK_CAPTURE(halveRows, sse2, halveRowSSE2);
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+BENCHMARK_CAPTURE(halveRows, neon, halveRowNEON);
+#endif
+
+int main(int argc, char **argv)
+{
+#if defined(__SSE2__)
+    // AVX2 只在支持的 CPU 上注册
+    if (hasAVX2())
+        benchmark::RegisterBenchmark("halveRows/avx2", halveRows, halveRowAVX2);
+#endif
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
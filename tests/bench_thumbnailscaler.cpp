@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "thumbnailscaler.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QImage>
+#include <QPainter>
+
+namespace {
+
+const QSize ThumbnailSize(200, 130);
+
+// 带阴影边框的 4K 窗口截图，srcRect 为去掉阴影后的区域
+QImage capture(const QSize &size)
+{
+    QImage image(size, QImage::Format_RGB32);
+    QPainter painter(&image);
+    painter.fillRect(image.rect(), Qt::darkGray);
+    for (int y = 0; y < size.height(); y += 48)
+        painter.fillRect(QRect(0, y, size.width(), 24), QColor(y % 256, 120, 200));
+    return image;
+}
+
+QRect contentRect(const QSize &size)
+{
+    return QRect(QPoint(0, 0), size).marginsRemoved(QMargins(40, 30, 40, 50));
+}
+
+void thumbnailScaler(benchmark::State &state)
+{
+    const QSize size(int(state.range(0)), int(state.range(1)));
+    const QImage source = capture(size);
+    const QRect rect = contentRect(size);
+    const QSize target = rect.size().scaled(ThumbnailSize, Qt::KeepAspectRatio);
+
+    QImage dst;
+    for (auto _ : state) {
+        ThumbnailScaler::scale(source, rect, target, dst);
+        benchmark::DoNotOptimize(dst.constBits());
+    }
+}
+
+// 修改前的做法：整张图平滑缩放后再裁剪
+void qimageScaled(benchmark::State &state)
+{
+    const QSize size(int(state.range(0)), int(state.range(1)));
+    const QImage source = capture(size);
+
+    for (auto _ : state) {
+        QImage scaled = source.scaled(ThumbnailSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        benchmark::DoNotOptimize(scaled.constBits());
+    }
+}
+
+// 悬停在有 10 个窗口的应用上，所有预览图需要在一帧内生成
+void tenWindows(benchmark::State &state)
+{
+    const QSize size(3840, 2160);
+    const QImage source = capture(size);
+    const QRect rect = contentRect(size);
+    const QSize target = rect.size().scaled(ThumbnailSize, Qt::KeepAspectRatio);
+
+    QImage dst[10];
+    for (auto _ : state) {
+        for (QImage &image : dst)
+            ThumbnailScaler::scale(source, rect, target, image);
+        benchmark::DoNotOptimize(dst[9].constBits());
+    }
+}
+
+} // namespace
+
+BENCHMARK(thumbnailScaler)->Args({1920, 1080})->Args({2560, 1440})->Args({3840, 2160})->Unit(benchmark::kMicrosecond);
+BENCHMARK(qimageScaled)->Args({1920, 1080})->Args({2560, 1440})->Args({3840, 2160})->Unit(benchmark::kMicrosecond);
+BENCHMARK(tenWindows)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
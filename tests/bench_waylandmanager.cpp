@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "taskmanager/waylandmanager.h"
+#include "taskmanager/windowinfok.h"
+#include "dbus/dockrect.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusContext>
+#include <QDBusMessage>
+#include <QThread>
+
+#include <functional>
+#include <random>
+
+// 需要会话总线，在私有总线上运行：dbus-run-session -- ./bench_waylandmanager
+
+namespace {
+
+const int WindowCount = 500;
+const QString Service = "org.deepin.dde.KWayland1";
+const QString Root = "/org/deepin/dde/KWayland1";
+
+QString windowPath(int index)
+{
+    return QString("%1/PlasmaWindow_%2").arg(Root).arg(index + 1);
+}
+
+// 假的 kwin，以子路径方式注册，按对象路径末尾的序号返回不同的窗口
+class FakePlasmaWindows : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.deepin.dde.KWayland1.PlasmaWindow")
+
+public Q_SLOTS:
+    QString AppId() { return QString("org.example.app%1").arg(index() % 50); }
+    bool IsValid() { return true; }
+    uint WindowId() { return 0x400000 + index(); }
+    uint InternalId() { return 1000 + index(); }
+    QString Icon() { return "application-x-executable"; }
+    QString Title() { return QString("Window %1").arg(index()); }
+    DockRect Geometry() { return DockRect(); }
+    bool IsDemandingAttention() { return false; }
+    bool IsCloseable() { return true; }
+    bool SkipTaskbar() { return false; }
+    bool IsMinimizeable() { return true; }
+    bool IsMinimized() { return false; }
+    uint Pid() { return 0; }
+
+private:
+    uint index() const { return message().path().section('_', -1).toUInt(); }
+};
+
+void spinUntil(const std::function<bool()> &done)
+{
+    while (!done())
+        QCoreApplication::processEvents(QEventLoop::AllEvents | QEventLoop::WaitForMoreEvents);
+}
+
+// 会话恢复时 500 个窗口同时注册：所有属性请求一次发出，等待全部返回
+void fetch500(benchmark::State &state)
+{
+    for (auto _ : state) {
+        QVector<WindowInfoK *> windows;
+        int finished = 0;
+        for (int i = 0; i < WindowCount; ++i) {
+            WindowInfoK *info = new WindowInfoK(new PlasmaWindow(Service, windowPath(i), QDBusConnection::sessionBus()));
+            info->fetchProperties([&finished] { ++finished; });
+            windows << info;
+        }
+        spinUntil([&] { return finished == WindowCount; });
+
+        state.PauseTiming();
+        qDeleteAll(windows);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * WindowCount);
+}
+
+class Fixture : public benchmark::Fixture
+{
+public:
+    void SetUp(const benchmark::State &) override
+    {
+        if (!m_windows.isEmpty())
+            return;
+
+        int finished = 0;
+        for (int i = 0; i < WindowCount; ++i) {
+            WindowInfoK *info = new WindowInfoK(new PlasmaWindow(Service, windowPath(i), QDBusConnection::sessionBus()));
+            info->fetchProperties([&finished] { ++finished; });
+            m_windows << info;
+        }
+        spinUntil([&] { return finished == WindowCount; });
+
+        for (int i = 0; i < WindowCount; ++i) {
+            m_windows.at(i)->changeXid(m_windows.at(i)->getWindowId());
+            m_manager.insertWindow(windowPath(i), m_windows.at(i));
+        }
+    }
+
+protected:
+    // 每次查找的目标随机，避免总是命中同一个窗口
+    std::vector<int> targets(size_t count) const
+    {
+        std::mt19937 random(1);
+        std::uniform_int_distribution<int> distribution(0, WindowCount - 1);
+        std::vector<int> result(count);
+        for (int &index : result)
+            index = distribution(random);
+        return result;
+    }
+
+    static WaylandManager m_manager;
+    static QVector<WindowInfoK *> m_windows;
+};
+
+WaylandManager Fixture::m_manager(nullptr);
+QVector<WindowInfoK *> Fixture::m_windows;
+
+// ActiveWindowChanged 时按 internalId 查找
+BENCHMARK_F(Fixture, findWindowById)(benchmark::State &state)
+{
+    const std::vector<int> ids = targets(1024);
+    size_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(m_manager.findWindowById(uint(1000 + ids[i++ & 1023] + 1)));
+}
+
+// 原先的实现：逐个窗口比较 innerId 字符串，作为对照
+BENCHMARK_F(Fixture, findWindowByIdLinear)(benchmark::State &state)
+{
+    const std::vector<int> ids = targets(1024);
+    size_t i = 0;
+    for (auto _ : state) {
+        const QString id = QString::number(1000 + ids[i++ & 1023] + 1);
+        WindowInfoK *found = nullptr;
+        for (WindowInfoK *window : m_windows) {
+            if (window->getInnerId() == id) {
+                found = window;
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+}
+
+BENCHMARK_F(Fixture, findWindowByXid)(benchmark::State &state)
+{
+    const std::vector<int> ids = targets(1024);
+    size_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(m_manager.findWindowByXid(XWindow(0x400000 + ids[i++ & 1023] + 1)));
+}
+
+BENCHMARK_F(Fixture, findWindowByObjPath)(benchmark::State &state)
+{
+    const std::vector<int> ids = targets(1024);
+    QStringList paths;
+    for (int id : ids)
+        paths << windowPath(id);
+
+    size_t i = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(m_manager.findWindowByObjPath(paths.at(int(i++ & 1023))));
+}
+
+} // namespace
+
+BENCHMARK(fetch500)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    registerDockRectMetaType();
+
+    if (!QDBusConnection::sessionBus().isConnected()) {
+        fprintf(stderr, "no session bus, run under dbus-run-session\n");
+        return 1;
+    }
+
+    QThread serviceThread;
+    serviceThread.start();
+    FakePlasmaWindows *fake = new FakePlasmaWindows;
+    fake->moveToThread(&serviceThread);
+
+    QDBusConnection connection = QDBusConnection::connectToBus(QDBusConnection::SessionBus, "fake-kwayland");
+    connection.registerObject(Root, fake, QDBusConnection::ExportAllSlots | QDBusConnection::SubPath);
+    connection.registerService(Service);
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+
+    QDBusConnection::disconnectFromBus("fake-kwayland");
+    serviceThread.quit();
+    serviceThread.wait();
+    delete fake;
+    return 0;
+}
+
+#include "bench_waylandmanager.moc"
@@ -0,0 +1,241 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "taskmanager/dbushandler.h"
+#include "util/perfstatistics.h"
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusContext>
+#include <QDBusError>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QThread>
+
+#include <functional>
+
+// 由 dbus-run-session 启动的私有会话总线运行，见 tests/CMakeLists.txt
+
+namespace {
+
+const QString Service = "org.deepin.dde.Application1.Manager";
+const QString Path = "/org/deepin/dde/Application1/Manager";
+
+// 假的应用管理服务，运行在单独的线程和连接上，这样同步调用也能得到回复
+class FakeManager : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.deepin.dde.Application1.Manager")
+
+public:
+    QStringList calls() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_calls;
+    }
+
+public Q_SLOTS:
+    void LaunchApp(const QString &desktopFile, uint timestamp, const QStringList &files)
+    {
+        append(QString("LaunchApp %1 %2 %3").arg(desktopFile).arg(timestamp).arg(files.join(',')));
+    }
+
+    void LaunchAppAction(const QString &desktopFile, const QString &action, uint timestamp)
+    {
+        append(QString("LaunchAppAction %1 %2 %3").arg(desktopFile).arg(action).arg(timestamp));
+    }
+
+    QString Echo(const QString &text)
+    {
+        return text;
+    }
+
+    // 永远不回复，用来触发超时
+    void Hang()
+    {
+        setDelayedReply(true);
+    }
+
+private:
+    void append(const QString &call)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_calls << call;
+    }
+
+private:
+    mutable QMutex m_mutex;
+    QStringList m_calls;
+};
+
+FakeManager *fakeManager = nullptr;
+
+bool waitFor(const std::function<bool()> &done, int msecs = 2000)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!done() && timer.elapsed() < msecs) {
+        QCoreApplication::processEvents();
+        QThread::msleep(1);
+    }
+    return done();
+}
+
+quint64 histogramCount(const QString &method)
+{
+    return PerfStatistics::instance()->statistics().value("dbus/" + method).toMap().value("count").toULongLong();
+}
+
+// 公开 DBusHandler 的调用辅助函数
+class TestHandler : public DBusHandler
+{
+public:
+    TestHandler() : DBusHandler(nullptr) {}
+
+    using DBusHandler::asyncCall;
+    using DBusHandler::blockingCall;
+};
+
+} // namespace
+
+class DBusHandlerTest : public ::testing::Test
+{
+protected:
+    void asyncCall(const char *method, const QVariantList &args, const std::function<void(const QDBusMessage &)> &callback, int timeout)
+    {
+        m_handler.asyncCall(Service, Path, Service, method, args, callback, timeout);
+    }
+
+    QDBusMessage blockingCall(const char *method, const QVariantList &args, int timeout)
+    {
+        return m_handler.blockingCall(Service, Path, Service, method, args, timeout);
+    }
+
+    TestHandler m_handler;
+};
+
+TEST_F(DBusHandlerTest, LaunchAppReachesService)
+{
+    const int before = fakeManager->calls().size();
+    m_handler.launchApp("/usr/share/applications/bench.desktop", 42, { "a.txt", "b.txt" });
+    m_handler.launchAppAction("/usr/share/applications/bench.desktop", "new-window", 43);
+
+    ASSERT_TRUE(waitFor([&] { return fakeManager->calls().size() == before + 2; }));
+    EXPECT_EQ(fakeManager->calls().at(before), "LaunchApp /usr/share/applications/bench.desktop 42 a.txt,b.txt");
+    EXPECT_EQ(fakeManager->calls().at(before + 1), "LaunchAppAction /usr/share/applications/bench.desktop new-window 43");
+}
+
+TEST_F(DBusHandlerTest, CallbackGetsReply)
+{
+    bool called = false;
+    QDBusMessage reply;
+    asyncCall("Echo", { "hello" }, [&](const QDBusMessage &message) {
+        called = true;
+        reply = message;
+    }, 2000);
+
+    // 回调只在事件循环里执行，不会在调用时同步执行
+    EXPECT_FALSE(called);
+    ASSERT_TRUE(waitFor([&] { return called; }));
+    EXPECT_EQ(reply.type(), QDBusMessage::ReplyMessage);
+    EXPECT_EQ(reply.arguments().value(0).toString(), "hello");
+}
+
+TEST_F(DBusHandlerTest, AsyncCallTimesOut)
+{
+    bool called = false;
+    QDBusMessage reply;
+    QElapsedTimer timer;
+    timer.start();
+    asyncCall("Hang", {}, [&](const QDBusMessage &message) {
+        called = true;
+        reply = message;
+    }, 200);
+
+    ASSERT_TRUE(waitFor([&] { return called; }, 3000));
+    EXPECT_EQ(reply.type(), QDBusMessage::ErrorMessage);
+    EXPECT_EQ(QDBusError(reply).type(), QDBusError::NoReply);
+    EXPECT_GE(timer.elapsed(), 150);
+    EXPECT_LT(timer.elapsed(), 2000);
+}
+
+TEST_F(DBusHandlerTest, AsyncCallToMissingServiceFails)
+{
+    bool called = false;
+    QDBusMessage reply;
+    m_handler.asyncCall("org.deepin.dde.Missing", "/", "org.deepin.dde.Missing", "Echo", {}, [&](const QDBusMessage &message) {
+        called = true;
+        reply = message;
+    }, 2000);
+
+    ASSERT_TRUE(waitFor([&] { return called; }));
+    EXPECT_EQ(reply.type(), QDBusMessage::ErrorMessage);
+}
+
+TEST_F(DBusHandlerTest, BlockingCallWaitsOnlyForTimeout)
+{
+    EXPECT_EQ(blockingCall("Echo", { "sync" }, 500).arguments().value(0).toString(), "sync");
+
+    QElapsedTimer timer;
+    timer.start();
+    const QDBusMessage reply = blockingCall("Hang", {}, 200);
+    EXPECT_EQ(reply.type(), QDBusMessage::ErrorMessage);
+    EXPECT_LT(timer.elapsed(), 2000);
+}
+
+#ifdef ENABLE_PERF_TIMERS
+TEST_F(DBusHandlerTest, CallsAreRecordedPerMethod)
+{
+    const quint64 echo = histogramCount("Echo");
+    const quint64 hang = histogramCount("Hang");
+
+    int replies = 0;
+    for (int i = 0; i < 3; ++i)
+        asyncCall("Echo", { "x" }, [&](const QDBusMessage &) { ++replies; }, 2000);
+    asyncCall("Hang", {}, [&](const QDBusMessage &) { ++replies; }, 100);
+    blockingCall("Echo", { "y" }, 500);
+
+    ASSERT_TRUE(waitFor([&] { return replies == 4; }));
+    EXPECT_EQ(histogramCount("Echo"), echo + 4);
+    EXPECT_EQ(histogramCount("Hang"), hang + 1);
+
+    // 超时的调用按超时时间记录
+    const QVariantMap entry = PerfStatistics::instance()->statistics().value("dbus/Hang").toMap();
+    EXPECT_GE(entry.value("max").toLongLong(), 100 * 1000);
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+
+    if (!QDBusConnection::sessionBus().isConnected()) {
+        fprintf(stderr, "no session bus, run under dbus-run-session\n");
+        return 1;
+    }
+
+    QThread serviceThread;
+    serviceThread.start();
+    fakeManager = new FakeManager;
+    fakeManager->moveToThread(&serviceThread);
+
+    QDBusConnection connection = QDBusConnection::connectToBus(QDBusConnection::SessionBus, "fake-manager");
+    connection.registerObject(Path, fakeManager, QDBusConnection::ExportAllSlots);
+    if (!connection.registerService(Service)) {
+        fprintf(stderr, "cannot register %s\n", qPrintable(Service));
+        return 1;
+    }
+
+    const int result = RUN_ALL_TESTS();
+
+    connection.unregisterService(Service);
+    QDBusConnection::disconnectFromBus("fake-manager");
+    serviceThread.quit();
+    serviceThread.wait();
+    delete fakeManager;
+    return result;
+}
+
+#include "ut_dbushandler.moc"
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "screenlayout.h"
+
+#include <gtest/gtest.h>
+
+using namespace Dock;
+
+namespace {
+
+quint8 edges(std::initializer_list<Position> positions)
+{
+    quint8 mask = 0;
+    for (Position position : positions)
+        mask |= 1 << position;
+    return mask;
+}
+
+// 屏幕区域按 DisplayManager 的方式换算：位置为原始坐标，大小乘以缩放
+QRect screen(int x, int y, int width, int height, qreal ratio = 1.0)
+{
+    return QRect(QPoint(x, y), QSize(width, height) * ratio);
+}
+
+} // namespace
+
+TEST(ScreenLayout, SingleScreenDocksEverywhere)
+{
+    ScreenLayout layout;
+    layout.setRects({ screen(0, 0, 1920, 1080) });
+
+    EXPECT_EQ(layout.dockableEdges(), QVector<quint8>({ ScreenLayout::AllEdges }));
+    EXPECT_FALSE(layout.isCopyMode());
+}
+
+TEST(ScreenLayout, ThreeScreensInARow)
+{
+    const QVector<quint8> result = ScreenLayout::dockableEdges({ screen(0, 0, 1920, 1080),
+                                                                 screen(1920, 0, 1920, 1080),
+                                                                 screen(3840, 0, 1920, 1080) });
+
+    EXPECT_EQ(result.at(0), edges({ Top, Bottom, Left }));
+    EXPECT_EQ(result.at(1), edges({ Top, Bottom }));
+    EXPECT_EQ(result.at(2), edges({ Top, Bottom, Right }));
+}
+
+TEST(ScreenLayout, TwoByTwoGrid)
+{
+    const QVector<quint8> result = ScreenLayout::dockableEdges({ screen(0, 0, 1920, 1080),
+                                                                 screen(1920, 0, 1920, 1080),
+                                                                 screen(0, 1080, 1920, 1080),
+                                                                 screen(1920, 1080, 1920, 1080) });
+
+    EXPECT_EQ(result.at(0), edges({ Top, Left }));
+    EXPECT_EQ(result.at(1), edges({ Top, Right }));
+    EXPECT_EQ(result.at(2), edges({ Bottom, Left }));
+    EXPECT_EQ(result.at(3), edges({ Bottom, Right }));
+}
+
+TEST(ScreenLayout, LShapedLayout)
+{
+    // A B
+    // C
+    const QVector<quint8> result = ScreenLayout::dockableEdges({ screen(0, 0, 1920, 1080),
+                                                                 screen(1920, 0, 1920, 1080),
+                                                                 screen(0, 1080, 1920, 1080) });
+
+    EXPECT_EQ(result.at(0), edges({ Top, Left }));
+    EXPECT_EQ(result.at(1), edges({ Top, Right, Bottom }));
+    EXPECT_EQ(result.at(2), edges({ Right, Bottom, Left }));
+}
+
+TEST(ScreenLayout, CornerTouchingScreensKeepAllEdges)
+{
+    const QVector<quint8> result = ScreenLayout::dockableEdges({ screen(0, 0, 1920, 1080),
+                                                                 screen(1920, 1080, 1920, 1080) });
+
+    EXPECT_EQ(result.at(0), ScreenLayout::AllEdges);
+    EXPECT_EQ(result.at(1), ScreenLayout::AllEdges);
+}
+
+TEST(ScreenLayout, MixedDevicePixelRatio)
+{
+    // 中间的 4K 屏幕缩放 2 倍，设备像素大小翻倍，底边比左屏低；右边的屏幕缩放 1.5 倍
+    ScreenLayout layout;
+    layout.setRects({ screen(0, 0, 1920, 1080), screen(1920, 0, 1920, 1080, 2.0), screen(5760, 0, 1280, 720, 1.5) });
+
+    EXPECT_EQ(layout.dockableEdges().at(0), edges({ Top, Bottom, Left }));
+    EXPECT_EQ(layout.dockableEdges().at(1), edges({ Top, Bottom }));
+    EXPECT_EQ(layout.dockableEdges().at(2), edges({ Top, Right, Bottom }));
+
+    EXPECT_EQ(layout.indexAt(QPoint(1919, 1079)), 0);
+    EXPECT_EQ(layout.indexAt(QPoint(1920, 2000)), 1);
+    EXPECT_EQ(layout.indexAt(QPoint(1000, 2000)), -1);
+    EXPECT_EQ(layout.indexAt(QPoint(5760, 1079)), 2);
+    EXPECT_EQ(layout.indexAt(QPoint(5760, 1080)), -1);
+}
+
+TEST(ScreenLayout, PartialOverlapOnlyBlocksSharedEdge)
+{
+    // 右屏向下错开 500 像素，共用的竖边仍然不可停靠
+    const QVector<quint8> result = ScreenLayout::dockableEdges({ screen(0, 0, 1920, 1080),
+                                                                 screen(1920, 500, 1920, 1080) });
+
+    EXPECT_EQ(result.at(0), edges({ Top, Bottom, Left }));
+    EXPECT_EQ(result.at(1), edges({ Top, Bottom, Right }));
+}
+
+TEST(ScreenLayout, MirroredScreens)
+{
+    ScreenLayout layout;
+    layout.setRects({ screen(0, 0, 1920, 1080), screen(0, 0, 1280, 1024) });
+
+    EXPECT_TRUE(layout.isCopyMode());
+    EXPECT_EQ(layout.dockableEdges().at(0), ScreenLayout::AllEdges);
+    EXPECT_EQ(layout.dockableEdges().at(1), ScreenLayout::AllEdges);
+
+    // 重叠区域属于靠前的屏幕
+    EXPECT_EQ(layout.indexAt(QPoint(100, 100)), 0);
+    EXPECT_EQ(layout.indexAt(QPoint(1500, 1050)), 0);
+}
+
+TEST(ScreenLayout, IndexAtBoundaries)
+{
+    ScreenLayout layout;
+    layout.setRects({ screen(0, 0, 1920, 1080), screen(1920, 0, 2560, 1440), screen(-1280, 0, 1280, 1024) });
+
+    EXPECT_EQ(layout.indexAt(QPoint(0, 0)), 0);
+    EXPECT_EQ(layout.indexAt(QPoint(1919, 0)), 0);
+    EXPECT_EQ(layout.indexAt(QPoint(1920, 0)), 1);
+    EXPECT_EQ(layout.indexAt(QPoint(4479, 1439)), 1);
+    EXPECT_EQ(layout.indexAt(QPoint(4480, 0)), -1);
+    EXPECT_EQ(layout.indexAt(QPoint(-1, 1023)), 2);
+    EXPECT_EQ(layout.indexAt(QPoint(-1, 1024)), -1);
+    EXPECT_EQ(layout.indexAt(QPoint(-1281, 0)), -1);
+    EXPECT_EQ(layout.indexAt(QPoint(0, -1)), -1);
+}
+
+TEST(ScreenLayout, EmptyLayout)
+{
+    ScreenLayout layout;
+    layout.setRects({});
+
+    EXPECT_TRUE(layout.dockableEdges().isEmpty());
+    EXPECT_FALSE(layout.isCopyMode());
+    EXPECT_EQ(layout.indexAt(QPoint(0, 0)), -1);
+}
@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "thumbnailkernels.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+using namespace ThumbnailKernels;
+
+namespace {
+
+struct Rows {
+    std::vector<uint32_t> r0;
+    std::vector<uint32_t> r1;
+};
+
+Rows randomRows(int count, std::mt19937 &random)
+{
+    Rows rows { std::vector<uint32_t>(size_t(count) * 2), std::vector<uint32_t>(size_t(count) * 2) };
+    for (size_t i = 0; i < rows.r0.size(); ++i) {
+        rows.r0[i] = random();
+        rows.r1[i] = random();
+    }
+    return rows;
+}
+
+std::vector<uint32_t> run(HalveRowFunc func, const Rows &rows, int count)
+{
+    std::vector<uint32_t> out(size_t(count), 0xdeadbeef);
+    func(rows.r0.data(), rows.r1.data(), out.data(), 0, count);
+    return out;
+}
+
+std::vector<HalveRowFunc> simdKernels()
+{
+    std::vector<HalveRowFunc> kernels;
+#if defined(__SSE2__)
+    kernels.push_back(halveRowSSE2);
+    if (hasAVX2())
+        kernels.push_back(halveRowAVX2);
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    kernels.push_back(halveRowNEON);
+#endif
+    return kernels;
+}
+
+} // namespace
+
+TEST(ThumbnailKernels, ScalarRoundsHalfUp)
+{
+    // 四个通道的和分别为 0、2、1、1020，结果为 (sum + 2) >> 2，即 0、1、0、255
+    const uint32_t r0[2] = { 0xff010000, 0xff000100 };
+    const uint32_t r1[2] = { 0xff000000, 0xff000100 };
+    uint32_t out = 0;
+    halveRowScalar(r0, r1, &out, 0, 1);
+    EXPECT_EQ(out, 0xff000100u);
+
+    const uint32_t white[2] = { 0xffffffff, 0xffffffff };
+    halveRowScalar(white, white, &out, 0, 1);
+    EXPECT_EQ(out, 0xffffffffu);
+}
+
+TEST(ThumbnailKernels, SimdMatchesScalarOnRandomRows)
+{
+    std::mt19937 random(20240517);
+    for (int count = 0; count <= 67; ++count) {
+        const Rows rows = randomRows(count, random);
+        const std::vector<uint32_t> expected = run(halveRowScalar, rows, count);
+
+        for (HalveRowFunc kernel : simdKernels())
+            EXPECT_EQ(run(kernel, rows, count), expected) << "count = " << count;
+    }
+}
+
+TEST(ThumbnailKernels, SimdMatchesScalarOnRoundingBoundaries)
+{
+    // 每个通道遍历 sum % 4 的所有余数，双重平均在这些值上会多进 1
+    const int count = 64;
+    Rows rows { std::vector<uint32_t>(count * 2), std::vector<uint32_t>(count * 2) };
+    for (int i = 0; i < count * 2; ++i) {
+        const uint32_t a = uint32_t(i * 37) & 0xff;
+        const uint32_t b = (a + uint32_t(i % 4)) & 0xff;
+        rows.r0[i] = a | (b << 8) | ((255 - a) << 16) | ((i & 1 ? 0u : 255u) << 24);
+        rows.r1[i] = b | (a << 8) | ((255 - b) << 16) | ((i & 2 ? 1u : 254u) << 24);
+    }
+
+    const std::vector<uint32_t> expected = run(halveRowScalar, rows, count);
+    for (HalveRowFunc kernel : simdKernels())
+        EXPECT_EQ(run(kernel, rows, count), expected);
+}
+
+TEST(ThumbnailKernels, StartsAtGivenIndex)
+{
+    std::mt19937 random(7);
+    const int count = 21;
+    const Rows rows = randomRows(count, random);
+    const std::vector<uint32_t> expected = run(halveRowScalar, rows, count);
+
+    for (HalveRowFunc kernel : simdKernels()) {
+        std::vector<uint32_t> out(count, 0);
+        kernel(rows.r0.data(), rows.r1.data(), out.data(), 5, count);
+        for (int i = 0; i < 5; ++i)
+            EXPECT_EQ(out[i], 0u);
+        for (int i = 5; i < count; ++i)
+            EXPECT_EQ(out[i], expected[i]);
+    }
+}
+
+TEST(ThumbnailKernels, DispatchUsesExactKernel)
+{
+    std::mt19937 random(3);
+    const int count = 40;
+    const Rows rows = randomRows(count, random);
+    EXPECT_EQ(run(halveRow(), rows, count), run(halveRowScalar, rows, count));
+}
@@ -0,0 +1,307 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "taskmanager/waylandmanager.h"
+#include "taskmanager/windowinfok.h"
+#include "dbus/dockrect.h"
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusContext>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QPointer>
+#include <QThread>
+
+#include <functional>
+
+// 由 dbus-run-session 启动的私有会话总线运行，见 tests/CMakeLists.txt
+
+namespace {
+
+const QString Service = "org.deepin.dde.KWayland1";
+const QString EditorPath = "/org/deepin/dde/KWayland1/PlasmaWindow_1";
+const QString NoPidPath = "/org/deepin/dde/KWayland1/PlasmaWindow_2";
+const QString DockPath = "/org/deepin/dde/KWayland1/PlasmaWindow_3";
+const QString InvalidPath = "/org/deepin/dde/KWayland1/PlasmaWindow_4";
+const QString MissingPath = "/org/deepin/dde/KWayland1/PlasmaWindow_404";
+
+// 假的 kwin 窗口对象，运行在单独的线程和连接上
+class FakePlasmaWindow : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.deepin.dde.KWayland1.PlasmaWindow")
+
+public:
+    FakePlasmaWindow(const QString &appId, bool valid, bool hasPid)
+        : m_appId(appId), m_valid(valid), m_hasPid(hasPid), m_title("Notes") {}
+
+    void setTitle(const QString &title)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_title = title;
+    }
+
+public Q_SLOTS:
+    QString AppId() { return m_appId; }
+    bool IsValid() { return m_valid; }
+    uint WindowId() { return 0x400001; }
+    uint InternalId() { return 7; }
+    QString Icon() { return "accessories-text-editor"; }
+    QString Title()
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_title;
+    }
+    DockRect Geometry()
+    {
+        DockRect rect;
+        rect.x = 10;
+        rect.y = 20;
+        rect.w = 800;
+        rect.h = 600;
+        return rect;
+    }
+    bool IsDemandingAttention() { return false; }
+    bool IsCloseable() { return true; }
+    bool SkipTaskbar() { return false; }
+    bool IsMinimizeable() { return true; }
+    bool IsMinimized() { return false; }
+
+    // kwin 取不到进程时返回错误
+    uint Pid()
+    {
+        if (!m_hasPid) {
+            sendErrorReply(QDBusError::Failed, "no pid");
+            return 0;
+        }
+        return uint(QCoreApplication::applicationPid());
+    }
+
+private:
+    const QString m_appId;
+    const bool m_valid;
+    const bool m_hasPid;
+    QMutex m_mutex;
+    QString m_title;
+};
+
+FakePlasmaWindow *editorWindow = nullptr;
+
+bool waitFor(const std::function<bool()> &done, int msecs = 2000)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!done() && timer.elapsed() < msecs) {
+        QCoreApplication::processEvents();
+        // 没有运行事件循环时 deleteLater 不会自动执行
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        QThread::msleep(1);
+    }
+    return done();
+}
+
+PlasmaWindow *createPlasmaWindow(const QString &path)
+{
+    return new PlasmaWindow(Service, path, QDBusConnection::sessionBus());
+}
+
+} // namespace
+
+TEST(WindowInfoK, FetchPropertiesCachesEveryValue)
+{
+    WindowInfoK info(createPlasmaWindow(EditorPath));
+    int finished = 0;
+    info.fetchProperties([&] { ++finished; });
+
+    // 所有请求都是异步的，返回前不会回调
+    EXPECT_EQ(finished, 0);
+    ASSERT_TRUE(waitFor([&] { return finished > 0; }));
+    waitFor([] { return false; }, 50);
+    EXPECT_EQ(finished, 1);
+
+    EXPECT_TRUE(info.isValid());
+    EXPECT_EQ(info.getAppId(), "org.example.editor");
+    EXPECT_EQ(info.getWindowId(), XWindow(0x400001));
+    EXPECT_EQ(info.getInternalId(), 7u);
+    EXPECT_EQ(info.getTitle(), "Notes");
+    EXPECT_EQ(info.getIcon(), "accessories-text-editor");
+    EXPECT_EQ(QRect(info.getGeometry()), QRect(10, 20, 800, 600));
+    EXPECT_FALSE(info.isMinimized());
+    EXPECT_FALSE(info.shouldSkip());
+
+    EXPECT_EQ(info.getPid(), int(QCoreApplication::applicationPid()));
+    EXPECT_NE(info.getProcess(), nullptr);
+}
+
+TEST(WindowInfoK, PidErrorStillCreatesProcessInfo)
+{
+    WindowInfoK info(createPlasmaWindow(NoPidPath));
+    int finished = 0;
+    info.fetchProperties([&] { ++finished; });
+
+    ASSERT_TRUE(waitFor([&] { return finished > 0; }));
+    EXPECT_EQ(info.getAppId(), "org.example.nopid");
+    EXPECT_EQ(info.getPid(), 0);
+    ASSERT_NE(info.getProcess(), nullptr);
+}
+
+TEST(WindowInfoK, MissingObjectFinishesInvalid)
+{
+    WindowInfoK info(createPlasmaWindow(MissingPath));
+    int finished = 0;
+    info.fetchProperties([&] { ++finished; });
+
+    ASSERT_TRUE(waitFor([&] { return finished > 0; }));
+    EXPECT_FALSE(info.isValid());
+    EXPECT_NE(info.getProcess(), nullptr);
+}
+
+TEST(WindowInfoK, UpdateReportsOnlyRealChanges)
+{
+    WindowInfoK info(createPlasmaWindow(EditorPath));
+    bool fetched = false;
+    info.fetchProperties([&] { fetched = true; });
+    ASSERT_TRUE(waitFor([&] { return fetched; }));
+
+    // 值没有变化时不回调
+    int changed = 0;
+    info.updateTitle([&] { ++changed; });
+    info.updateGeometry([&] { ++changed; });
+    waitFor([] { return false; }, 200);
+    EXPECT_EQ(changed, 0);
+
+    editorWindow->setTitle("Notes - edited");
+    info.updateTitle([&] { ++changed; });
+    ASSERT_TRUE(waitFor([&] { return changed == 1; }));
+    EXPECT_EQ(info.getTitle(), "Notes - edited");
+    editorWindow->setTitle("Notes");
+}
+
+// 公开 WaylandManager 获取窗口属性的流程
+class TestManager : public WaylandManager
+{
+public:
+    TestManager() : WaylandManager(nullptr) {}
+
+    using WaylandManager::fetchWindow;
+    using WaylandManager::pendingWindows;
+};
+
+// WaylandManager 的 TaskManager 传空指针：窗口一旦走到注册那一步就会崩溃，
+// 因此下面的用例同时验证了被丢弃的窗口不会进入注册流程
+class WaylandManagerTest : public ::testing::Test
+{
+protected:
+    QPointer<WindowInfoK> fetch(const QString &path)
+    {
+        m_manager.fetchWindow(path, createPlasmaWindow(path));
+        return m_manager.pendingWindows().value(path);
+    }
+
+    int pendingCount() const { return m_manager.pendingWindows().size(); }
+
+    TestManager m_manager;
+};
+
+TEST_F(WaylandManagerTest, UnregisterWhilePendingDropsWindow)
+{
+    QPointer<WindowInfoK> info = fetch(EditorPath);
+    ASSERT_FALSE(info.isNull());
+    EXPECT_EQ(pendingCount(), 1);
+
+    // 属性还没有返回时窗口就关闭了
+    m_manager.unRegisterWindow(EditorPath);
+    EXPECT_EQ(pendingCount(), 0);
+
+    ASSERT_TRUE(waitFor([&] { return info.isNull(); }));
+    waitFor([] { return false; }, 100);
+    EXPECT_EQ(m_manager.findWindowByObjPath(EditorPath), nullptr);
+}
+
+TEST_F(WaylandManagerTest, RegisterWhilePendingIsIgnored)
+{
+    QPointer<WindowInfoK> info = fetch(EditorPath);
+
+    // 已在等待属性的窗口直接返回，不会再创建 PlasmaWindow
+    m_manager.registerWindow(EditorPath);
+    EXPECT_EQ(pendingCount(), 1);
+    EXPECT_EQ(m_manager.pendingWindows().value(EditorPath), info.data());
+
+    m_manager.unRegisterWindow(EditorPath);
+    ASSERT_TRUE(waitFor([&] { return info.isNull(); }));
+}
+
+TEST_F(WaylandManagerTest, ReRegisterAfterUnregisterKeepsOnlyNewFetch)
+{
+    QPointer<WindowInfoK> first = fetch(DockPath);
+    m_manager.unRegisterWindow(DockPath);
+    QPointer<WindowInfoK> second = fetch(DockPath);
+
+    ASSERT_TRUE(waitFor([&] { return first.isNull() && second.isNull(); }));
+    EXPECT_EQ(pendingCount(), 0);
+}
+
+TEST_F(WaylandManagerTest, FilteredAppIsDropped)
+{
+    QPointer<WindowInfoK> info = fetch(DockPath);
+
+    ASSERT_TRUE(waitFor([&] { return info.isNull(); }));
+    EXPECT_EQ(pendingCount(), 0);
+    EXPECT_EQ(m_manager.findWindowByObjPath(DockPath), nullptr);
+}
+
+TEST_F(WaylandManagerTest, InvalidWindowIsDropped)
+{
+    QPointer<WindowInfoK> info = fetch(InvalidPath);
+
+    ASSERT_TRUE(waitFor([&] { return info.isNull(); }));
+    EXPECT_EQ(pendingCount(), 0);
+    EXPECT_EQ(m_manager.findWindowByObjPath(InvalidPath), nullptr);
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    registerDockRectMetaType();
+
+    if (!QDBusConnection::sessionBus().isConnected()) {
+        fprintf(stderr, "no session bus, run under dbus-run-session\n");
+        return 1;
+    }
+
+    QThread serviceThread;
+    serviceThread.start();
+
+    editorWindow = new FakePlasmaWindow("org.example.editor", true, true);
+    QList<QPair<QString, FakePlasmaWindow *>> windows {
+        { EditorPath, editorWindow },
+        { NoPidPath, new FakePlasmaWindow("org.example.nopid", true, false) },
+        { DockPath, new FakePlasmaWindow("dde-dock", true, true) },
+        { InvalidPath, new FakePlasmaWindow("org.example.invalid", false, true) },
+    };
+
+    QDBusConnection connection = QDBusConnection::connectToBus(QDBusConnection::SessionBus, "fake-kwayland");
+    for (const auto &window : windows) {
+        window.second->moveToThread(&serviceThread);
+        connection.registerObject(window.first, window.second, QDBusConnection::ExportAllSlots);
+    }
+    if (!connection.registerService(Service)) {
+        fprintf(stderr, "cannot register %s\n", qPrintable(Service));
+        return 1;
+    }
+
+    const int result = RUN_ALL_TESTS();
+
+    connection.unregisterService(Service);
+    QDBusConnection::disconnectFromBus("fake-kwayland");
+    serviceThread.quit();
+    serviceThread.wait();
+    for (const auto &window : windows)
+        delete window.second;
+    return result;
+}
+
+#include "ut_waylandmanager.moc"